@@ -0,0 +1,122 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../memory/MonotonicArena.hpp"
+#include "../memory/ObjectPool.hpp"
+#include "Bench.hpp"
+
+namespace {
+
+constexpr std::size_t BatchSize = 64;
+constexpr std::size_t Rounds = 256;
+constexpr std::size_t MaxAllocation = 256;
+
+// Every thread repeatedly allocates a batch of 16..256 byte blocks, writes
+// to each of them and frees the whole batch, the pattern of a request that
+// builds a few short-lived buffers.
+template <typename Allocate, typename FreeBatch>
+void Churn(std::size_t thread_index, Allocate&& allocate, FreeBatch&& free_batch) {
+  std::uint32_t state = static_cast<std::uint32_t>(thread_index) * 2654435761u + 1;
+  std::array<void*, BatchSize> batch;
+  std::array<std::size_t, BatchSize> sizes;
+  for (std::size_t round = 0; round < Rounds; ++round) {
+    for (std::size_t i = 0; i < BatchSize; ++i) {
+      state = state * 1664525u + 1013904223u;
+      sizes[i] = 16 + (state >> 8) % (MaxAllocation - 15);
+      batch[i] = allocate(sizes[i]);
+      static_cast<volatile std::byte*>(batch[i])[0] = std::byte{1};
+    }
+    free_batch(batch, sizes);
+  }
+}
+
+template <typename Body>
+void OnThreads(std::size_t threads, Body&& body) {
+  std::vector<std::thread> workers;
+  for (std::size_t t = 1; t < threads; ++t) {
+    workers.emplace_back(body, t);
+  }
+  body(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void ResourceChurn(std::size_t thread_index, std::pmr::memory_resource& resource) {
+  Churn(thread_index,
+        [&](std::size_t size) { return resource.allocate(size); },
+        [&](const auto& batch, const auto& sizes) {
+          for (std::size_t i = 0; i < BatchSize; ++i) {
+            resource.deallocate(batch[i], sizes[i]);
+          }
+        });
+}
+
+void Benchmarks(bench::Suite& suite, std::size_t threads) {
+  const auto suffix = "/threads=" + std::to_string(threads);
+  const auto items = threads * Rounds * BatchSize;
+
+  suite.Run("alloc/malloc" + suffix, items, [&] {
+    OnThreads(threads, [](std::size_t t) {
+      Churn(t,
+            [](std::size_t size) { return std::malloc(size); },
+            [](const auto& batch, const auto&) {
+              for (void* block : batch) {
+                std::free(block);
+              }
+            });
+    });
+  });
+
+  std::vector<std::unique_ptr<MonotonicArena>> arenas;
+  for (std::size_t t = 0; t < threads; ++t) {
+    arenas.push_back(std::make_unique<MonotonicArena>());
+  }
+  suite.Run("alloc/MonotonicArena" + suffix, items, [&] {
+    OnThreads(threads, [&](std::size_t t) {
+      auto& arena = *arenas[t];
+      Churn(t,
+            [&](std::size_t size) { return arena.Allocate(size); },
+            [&](const auto&, const auto&) { arena.Reset(); });
+    });
+  });
+
+  FixedBlockPool pool{MaxAllocation, threads * BatchSize};
+  suite.Run("alloc/FixedBlockPool" + suffix, items, [&] {
+    OnThreads(threads, [&](std::size_t t) {
+      Churn(t,
+            [&](std::size_t) { return pool.TryAllocate(); },
+            [&](const auto& batch, const auto&) {
+              for (void* block : batch) {
+                pool.Release(block);
+              }
+            });
+    });
+  });
+
+  suite.Run("alloc/FixedBlockPool_pmr" + suffix, items, [&] {
+    OnThreads(threads, [&](std::size_t t) { ResourceChurn(t, pool); });
+  });
+
+  std::pmr::synchronized_pool_resource std_pool;
+  suite.Run("alloc/synchronized_pool_resource" + suffix, items, [&] {
+    OnThreads(threads, [&](std::size_t t) { ResourceChurn(t, std_pool); });
+  });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bench::Suite suite{argc, argv};
+  for (const std::size_t threads : {1, 2, 4, 8, 16}) {
+    Benchmarks(suite, threads);
+  }
+  return suite.Finish();
+}
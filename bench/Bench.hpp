@@ -0,0 +1,305 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Minimal benchmark harness: wall-clock timing with calibration, optional
+// hardware counters through perf_event_open and JSON output for comparing
+// runs. Benchmarks are plain executables built from one translation unit.
+namespace bench {
+
+template <typename T>
+inline void DoNotOptimize(const T& value) noexcept {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void ClobberMemory() noexcept {
+  asm volatile("" : : : "memory");
+}
+
+inline constexpr std::size_t CounterCount = 4;
+
+inline constexpr std::array<std::string_view, CounterCount> CounterNames{
+  "cycles", "instructions", "l1d_misses", "llc_misses",
+};
+
+using CounterValues = std::array<std::optional<double>, CounterCount>;
+
+
+// PerfCounters
+//
+// One perf event per counter for the calling thread and the threads it starts
+// later, user space only. Events the kernel or the machine refuses
+// (containers, VMs, perf_event_paranoid) stay unavailable and read as null.
+class PerfCounters {
+ public:
+  PerfCounters() noexcept {
+#if defined(__linux__)
+    constexpr std::uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D |
+                                            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    fds_[0] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds_[1] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds_[2] = Open(PERF_TYPE_HW_CACHE, l1d_read_miss);
+    fds_[3] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif
+  }
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  ~PerfCounters() {
+#if defined(__linux__)
+    for (const int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+#endif
+  }
+
+  bool Available() const noexcept {
+    return std::any_of(fds_.begin(), fds_.end(), [](int fd) { return fd >= 0; });
+  }
+
+  void Start() noexcept {
+#if defined(__linux__)
+    for (const int fd : fds_) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  // Counts since Start, scaled up when the kernel multiplexed the events.
+  CounterValues Stop() noexcept {
+    CounterValues values{};
+#if defined(__linux__)
+    for (std::size_t i = 0; i < CounterCount; ++i) {
+      if (fds_[i] < 0) {
+        continue;
+      }
+      ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+      std::uint64_t reading[3];
+      if (read(fds_[i], reading, sizeof(reading)) == sizeof(reading) && reading[2] != 0) {
+        values[i] = static_cast<double>(reading[0]) * static_cast<double>(reading[1]) / static_cast<double>(reading[2]);
+      }
+    }
+#endif
+    return values;
+  }
+
+ private:
+#if defined(__linux__)
+  static int Open(std::uint32_t type, std::uint64_t config) noexcept {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+#endif
+
+  std::array<int, CounterCount> fds_{-1, -1, -1, -1};
+};
+
+
+struct Result {
+  std::string name;
+  std::size_t items;
+  std::size_t iterations;
+  double ns_per_item;
+  double min_ns_per_item;
+  CounterValues counters_per_item;
+  // Benchmark specific figures such as latency percentiles.
+  std::vector<std::pair<std::string, double>> metrics;
+};
+
+
+// Suite
+//
+// Runs the benchmarks selected on the command line:
+//   --filter=<substring>  only names containing the substring
+//   --json=<path>         also write the results as JSON
+//   --min-time=<ms>       minimal duration of every sample, default 20
+//   --samples=<n>         samples per benchmark, default 7
+// A benchmark is func(), processing `items` items per call. The reported
+// time is the median over samples, counters are averaged over all samples.
+class Suite {
+ public:
+  Suite(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view arg = argv[i];
+      if (arg.starts_with("--filter=")) {
+        filter_ = arg.substr(9);
+      } else if (arg.starts_with("--json=")) {
+        json_path_ = arg.substr(7);
+      } else if (arg.starts_with("--min-time=")) {
+        min_time_ = std::chrono::milliseconds{std::atoll(argv[i] + 11)};
+      } else if (arg.starts_with("--samples=")) {
+        samples_ = std::max(1, std::atoi(argv[i] + 10));
+      } else {
+        std::fprintf(stderr, "unknown argument %s\n", argv[i]);
+        std::exit(2);
+      }
+    }
+    std::printf("%-48s %12s %12s", "benchmark", "ns/item", "min ns/item");
+    for (std::size_t i = 0; i < CounterCount; ++i) {
+      std::printf(" %12s", CounterNames[i].data());
+    }
+    std::printf("\n");
+  }
+
+  bool Selected(std::string_view name) const noexcept {
+    return name.find(filter_) != std::string_view::npos;
+  }
+
+  // Returns the median ns per item, 0 when the filter skips the benchmark.
+  template <typename Func>
+  double Run(std::string_view name, std::size_t items, Func&& func) {
+    if (!Selected(name)) {
+      return 0;
+    }
+    using Clock = std::chrono::steady_clock;
+
+    // Grow the iteration count until one sample takes at least min_time_.
+    std::size_t iterations = 1;
+    while (true) {
+      const auto start = Clock::now();
+      for (std::size_t i = 0; i < iterations; ++i) {
+        func();
+      }
+      const auto elapsed = Clock::now() - start;
+      if (elapsed >= min_time_ || iterations >= (std::size_t{1} << 40)) {
+        break;
+      }
+      const auto ratio = elapsed.count() > 0 ? static_cast<double>(min_time_ / std::chrono::nanoseconds{1}) /
+                                                 static_cast<double>(std::chrono::nanoseconds{elapsed}.count())
+                                             : 100.0;
+      iterations = static_cast<std::size_t>(static_cast<double>(iterations) * std::clamp(ratio * 1.2, 2.0, 100.0));
+    }
+
+    std::vector<double> times;
+    CounterValues totals{};
+    for (int sample = 0; sample < samples_; ++sample) {
+      counters_.Start();
+      const auto start = Clock::now();
+      for (std::size_t i = 0; i < iterations; ++i) {
+        func();
+      }
+      const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+      const auto counts = counters_.Stop();
+      times.push_back(elapsed / static_cast<double>(iterations * items));
+      for (std::size_t i = 0; i < CounterCount; ++i) {
+        if (counts[i]) {
+          totals[i] = totals[i].value_or(0.0) + *counts[i];
+        }
+      }
+    }
+
+    std::sort(times.begin(), times.end());
+    Result result{std::string{name}, items, iterations, times[times.size() / 2], times.front(), {}, {}};
+    const auto processed = static_cast<double>(iterations * items) * samples_;
+    for (std::size_t i = 0; i < CounterCount; ++i) {
+      if (totals[i]) {
+        result.counters_per_item[i] = *totals[i] / processed;
+      }
+    }
+    Print(result);
+    results_.push_back(std::move(result));
+    return results_.back().ns_per_item;
+  }
+
+  // Attaches an extra figure to the result of the benchmark named run, and
+  // does nothing when the filter skipped that benchmark.
+  void Metric(std::string_view run, std::string_view key, double value) {
+    const auto result = std::find_if(results_.rbegin(), results_.rend(), [run](const Result& result) {
+      return result.name == run;
+    });
+    if (result == results_.rend()) {
+      return;
+    }
+    std::printf("  %-46s %12.4f\n", std::string{key}.c_str(), value);
+    result->metrics.emplace_back(key, value);
+  }
+
+  // Writes the JSON file if one was requested, returns the exit code.
+  int Finish() const {
+    if (json_path_.empty()) {
+      return 0;
+    }
+    std::FILE* file = std::fopen(json_path_.c_str(), "w");
+    if (file == nullptr) {
+      std::fprintf(stderr, "cannot open %s\n", json_path_.c_str());
+      return 1;
+    }
+    std::fprintf(file, "{\n  \"counters_available\": %s,\n  \"benchmarks\": [\n", counters_.Available() ? "true" : "false");
+    for (std::size_t r = 0; r < results_.size(); ++r) {
+      const auto& result = results_[r];
+      std::fprintf(file, "    {\"name\": \"%s\", \"items\": %zu, \"iterations\": %zu, \"ns_per_item\": %.6g, \"min_ns_per_item\": %.6g",
+                   result.name.c_str(), result.items, result.iterations, result.ns_per_item, result.min_ns_per_item);
+      for (std::size_t i = 0; i < CounterCount; ++i) {
+        if (result.counters_per_item[i]) {
+          std::fprintf(file, ", \"%s_per_item\": %.6g", CounterNames[i].data(), *result.counters_per_item[i]);
+        } else {
+          std::fprintf(file, ", \"%s_per_item\": null", CounterNames[i].data());
+        }
+      }
+      for (const auto& [key, value] : result.metrics) {
+        std::fprintf(file, ", \"%s\": %.6g", key.c_str(), value);
+      }
+      std::fprintf(file, "}%s\n", r + 1 < results_.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    std::fclose(file);
+    return 0;
+  }
+
+ private:
+  static void Print(const Result& result) {
+    std::printf("%-48s %12.4f %12.4f", result.name.c_str(), result.ns_per_item, result.min_ns_per_item);
+    for (const auto& value : result.counters_per_item) {
+      if (value) {
+        std::printf(" %12.4f", *value);
+      } else {
+        std::printf(" %12s", "-");
+      }
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+  }
+
+  std::string filter_;
+  std::string json_path_;
+  std::chrono::nanoseconds min_time_ = std::chrono::milliseconds{20};
+  int samples_ = 7;
+  PerfCounters counters_;
+  std::vector<Result> results_;
+};
+
+} // namespace bench
@@ -0,0 +1,77 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../column/CompressedColumn.hpp"
+#include "Bench.hpp"
+
+namespace {
+
+constexpr std::size_t ColumnSize = 16 << 20;
+
+// Microsecond timestamps of events arriving every few hundred microseconds.
+std::vector<std::uint64_t> MakeTimestamps() {
+  std::mt19937_64 random{ColumnSize};
+  std::vector<std::uint64_t> values(ColumnSize);
+  std::uint64_t now = 1'714'564'800'000'000;
+  for (auto& value : values) {
+    now += random() % 2000;
+    value = now;
+  }
+  return values;
+}
+
+// Identifiers drawn from a small dictionary, in no particular order.
+std::vector<std::uint64_t> MakeIds() {
+  std::mt19937_64 random{ColumnSize + 1};
+  std::vector<std::uint64_t> values(ColumnSize);
+  for (auto& value : values) {
+    value = random() % 1000;
+  }
+  return values;
+}
+
+// Sequential scan through a ColumnReader, reporting the compression ratio and
+// the decoded bytes per second.
+template <typename Codec>
+void ScanBenchmark(bench::Suite& suite, const std::string& name, const std::vector<std::uint64_t>& values) {
+  const CompressedColumn<std::uint64_t, Codec> column{Span<const std::uint64_t>{values.data(), values.size()}};
+  const double ns = suite.Run(name, values.size(), [&] {
+    ColumnReader reader{column};
+    std::uint64_t sum = 0;
+    reader.ForEachBlock([&sum](Span<const std::uint64_t> block) {
+      for (const auto value : block) {
+        sum += value;
+      }
+    });
+    bench::DoNotOptimize(sum);
+  });
+  suite.Metric(name, "compression_ratio", static_cast<double>(values.size() * sizeof(std::uint64_t)) /
+                                              static_cast<double>(column.SizeBytes()));
+  suite.Metric(name, "decode_GB/s", sizeof(std::uint64_t) / ns);
+}
+
+void Benchmarks(bench::Suite& suite, const std::string& data, const std::vector<std::uint64_t>& values) {
+  const auto name = "scan/" + data + "/uncompressed";
+  const double ns = suite.Run(name, values.size(), [&] {
+    std::uint64_t sum = 0;
+    for (const auto value : values) {
+      sum += value;
+    }
+    bench::DoNotOptimize(sum);
+  });
+  suite.Metric(name, "decode_GB/s", sizeof(std::uint64_t) / ns);
+  ScanBenchmark<FrameOfReference>(suite, "scan/" + data + "/FrameOfReference", values);
+  ScanBenchmark<DeltaVarint>(suite, "scan/" + data + "/DeltaVarint", values);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bench::Suite suite{argc, argv};
+  Benchmarks(suite, "timestamps", MakeTimestamps());
+  Benchmarks(suite, "ids", MakeIds());
+  return suite.Finish();
+}
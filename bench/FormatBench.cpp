@@ -0,0 +1,90 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <vector>
+#include <version>
+
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+#include "../format/Format.hpp"
+#include "Bench.hpp"
+
+namespace {
+
+constexpr std::size_t RecordCount = 4096;
+
+// The five fields of a service log line.
+struct Record {
+  std::uint64_t timestamp;
+  std::string_view level;
+  int thread;
+  double latency_ms;
+  std::string_view message;
+};
+
+std::vector<Record> MakeRecords() {
+  static constexpr std::string_view levels[] = {"INFO", "INFO", "INFO", "WARN", "ERROR"};
+  static constexpr std::string_view messages[] = {"request served", "cache miss", "upstream timeout",
+                                                  "retrying request after connection reset"};
+  std::mt19937_64 random{2024};
+  std::vector<Record> records(RecordCount);
+  for (auto& record : records) {
+    record = {1'714'564'800'000'000 + random() % 1'000'000'000, levels[random() % std::size(levels)],
+              static_cast<int>(random() % 64), static_cast<double>(random() % 1'000'000) / 997.0,
+              messages[random() % std::size(messages)]};
+  }
+  return records;
+}
+
+// Formats every record into the same line buffer.
+template <typename Func>
+void FormatLines(const std::vector<Record>& records, Func&& format) {
+  std::array<char, 256> line;
+  std::size_t size = 0;
+  for (const auto& record : records) {
+    size += format(line.data(), line.size(), record);
+  }
+  bench::DoNotOptimize(size);
+  bench::ClobberMemory();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bench::Suite suite{argc, argv};
+  const auto records = MakeRecords();
+
+  suite.Run("log_line/snprintf", records.size(), [&] {
+    FormatLines(records, [](char* out, std::size_t size, const Record& record) {
+      const int written = std::snprintf(out, size, "%llu %.*s tid=%d took=%.3fms %.*s\n",
+                                        static_cast<unsigned long long>(record.timestamp),
+                                        static_cast<int>(record.level.size()), record.level.data(), record.thread,
+                                        record.latency_ms, static_cast<int>(record.message.size()),
+                                        record.message.data());
+      return static_cast<std::size_t>(written);
+    });
+  });
+#if defined(__cpp_lib_format)
+  suite.Run("log_line/std_format_to_n", records.size(), [&] {
+    FormatLines(records, [](char* out, std::size_t size, const Record& record) {
+      const auto result = std::format_to_n(out, static_cast<std::ptrdiff_t>(size), "{} {} tid={} took={:.3f}ms {}\n",
+                                           record.timestamp, record.level, record.thread, record.latency_ms,
+                                           record.message);
+      return static_cast<std::size_t>(result.size);
+    });
+  });
+#endif
+  suite.Run("log_line/FormatTo", records.size(), [&] {
+    FormatLines(records, [](char* out, std::size_t size, const Record& record) {
+      return FormatTo<"{} {} tid={} took={:.3}ms {}\n"_cstr>(Span<char>{out, size}, record.timestamp, record.level,
+                                                             record.thread, record.latency_ms, record.message)
+          .value_or(0);
+    });
+  });
+  return suite.Finish();
+}
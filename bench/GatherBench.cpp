@@ -0,0 +1,65 @@
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../slice/IndexedSlice.hpp"
+#include "Bench.hpp"
+
+namespace {
+
+constexpr std::size_t IndexCount = 1 << 20;
+
+template <typename Value>
+void Benchmarks(bench::Suite& suite, const std::string& type, std::size_t base_size) {
+  std::vector<Value> base(base_size);
+  std::iota(base.begin(), base.end(), Value{0});
+  std::vector<std::uint32_t> indices(IndexCount);
+  std::mt19937 random{7};
+  for (auto& index : indices) {
+    index = static_cast<std::uint32_t>(random() % base_size);
+  }
+  std::vector<Value> out(IndexCount);
+
+  const Span<const std::uint32_t> index_span{indices.data(), indices.size()};
+  const Span<Value> out_span{out.data(), out.size()};
+  const auto view = Indexed(Span<Value>{base.data(), base.size()}, index_span);
+  const auto prefix = "gather/" + type + "/base=" + std::to_string(base_size * sizeof(Value) >> 10) + "KiB/";
+
+  suite.Run(prefix + "loop", IndexCount, [&] {
+    for (std::size_t i = 0; i < IndexCount; ++i) {
+      out[i] = base[indices[i]];
+    }
+    bench::ClobberMemory();
+  });
+  for (const std::size_t distance : {0, 16, 64}) {
+    suite.Run(prefix + "Gather/distance=" + std::to_string(distance), IndexCount, [&] {
+      view.Gather(out_span, distance);
+      bench::ClobberMemory();
+    });
+  }
+  for (const auto& [name, order] : {std::pair{"Sorted", GatherOrder::Sorted}, std::pair{"Bucketed", GatherOrder::Bucketed}}) {
+    const GatherPlan plan{index_span, order};
+    suite.Run(prefix + "Gather/plan=" + name, IndexCount, [&] {
+      view.Gather(out_span, plan);
+      bench::ClobberMemory();
+    });
+  }
+  suite.Run(prefix + "Scatter", IndexCount, [&] {
+    view.Scatter(Span<const Value>{out.data(), out.size()});
+    bench::ClobberMemory();
+  });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bench::Suite suite{argc, argv};
+  for (const std::size_t base_size : {std::size_t{1} << 16, std::size_t{1} << 20, std::size_t{1} << 25}) {
+    Benchmarks<std::uint32_t>(suite, "u32", base_size);
+    Benchmarks<double>(suite, "f64", base_size);
+  }
+  return suite.Finish();
+}
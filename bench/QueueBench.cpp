@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../queue/BatchQueue.hpp"
+#include "Bench.hpp"
+
+namespace {
+
+constexpr std::size_t Capacity = 4096;
+constexpr std::size_t ItemsPerRun = 64 * 1024;
+
+// The mutex-protected queue the batch queues replace.
+template <typename T>
+class LockedQueue {
+ public:
+  bool TryPush(T value) {
+    std::lock_guard lock{mutex_};
+    if (items_.size() == Capacity) {
+      return false;
+    }
+    items_.push_back(value);
+    return true;
+  }
+
+  std::optional<T> TryPop() {
+    std::lock_guard lock{mutex_};
+    if (items_.empty()) {
+      return std::nullopt;
+    }
+    const T value = items_.front();
+    items_.pop_front();
+    return value;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::deque<T> items_;
+};
+
+// Items are send timestamps, so the consumer can tell how long each waited.
+std::uint64_t Now() noexcept {
+  return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+template <typename Queue>
+void Produce(Queue& queue, std::size_t count, std::size_t batch) {
+  for (std::size_t sent = 0; sent < count;) {
+    if constexpr (requires { queue.ReserveWrite(batch); }) {
+      const auto reservation = queue.ReserveWrite(std::min(batch, count - sent));
+      const auto stamp = Now();
+      for (auto& slot : reservation.slots) {
+        slot = stamp;
+      }
+      queue.CommitWrite(reservation);
+      sent += reservation.Size();
+      if (reservation.Empty()) {
+        std::this_thread::yield();
+      }
+    } else if (queue.TryPush(Now())) {
+      ++sent;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+template <typename Queue>
+void Consume(Queue& queue, std::atomic<std::size_t>& remaining, std::size_t batch, std::vector<std::uint64_t>* latencies) {
+  while (remaining.load(std::memory_order_relaxed) != 0) {
+    std::size_t received = 0;
+    if constexpr (requires { queue.ReserveRead(batch); }) {
+      const auto reservation = queue.ReserveRead(batch);
+      if (latencies != nullptr && !reservation.Empty()) {
+        const auto now = Now();
+        for (const auto stamp : reservation.slots) {
+          latencies->push_back(now - stamp);
+        }
+      }
+      queue.CommitRead(reservation);
+      received = reservation.Size();
+    } else if (const auto stamp = queue.TryPop()) {
+      if (latencies != nullptr) {
+        latencies->push_back(Now() - *stamp);
+      }
+      received = 1;
+    }
+    if (received == 0) {
+      std::this_thread::yield();
+    } else {
+      remaining.fetch_sub(received, std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename Queue>
+void Transfer(std::size_t producers, std::size_t consumers, std::size_t batch, std::vector<std::uint64_t>* latencies) {
+  Queue queue;
+  std::atomic<std::size_t> remaining{ItemsPerRun};
+  std::vector<std::vector<std::uint64_t>> consumer_latencies(consumers);
+  std::vector<std::thread> threads;
+  for (std::size_t p = 0; p < producers; ++p) {
+    const auto count = ItemsPerRun / producers + (p < ItemsPerRun % producers);
+    threads.emplace_back([&, count] { Produce(queue, count, batch); });
+  }
+  for (std::size_t c = 0; c < consumers; ++c) {
+    threads.emplace_back([&, c] {
+      Consume(queue, remaining, batch, latencies != nullptr ? &consumer_latencies[c] : nullptr);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (latencies != nullptr) {
+    for (const auto& part : consumer_latencies) {
+      latencies->insert(latencies->end(), part.begin(), part.end());
+    }
+  }
+}
+
+// Throughput from the timed runs, then one more run recording the queueing
+// delay of every item for the percentiles.
+template <typename Queue>
+void Measure(bench::Suite& suite, const std::string& name, std::size_t producers, std::size_t consumers, std::size_t batch) {
+  if (!suite.Selected(name)) {
+    return;
+  }
+  suite.Run(name, ItemsPerRun, [&] { Transfer<Queue>(producers, consumers, batch, nullptr); });
+
+  std::vector<std::uint64_t> latencies;
+  latencies.reserve(ItemsPerRun);
+  Transfer<Queue>(producers, consumers, batch, &latencies);
+  std::sort(latencies.begin(), latencies.end());
+  for (const auto& [key, quantile] : {std::pair{"latency_p50_ns", 0.5}, {"latency_p99_ns", 0.99}, {"latency_p999_ns", 0.999}}) {
+    suite.Metric(name, key, static_cast<double>(latencies[static_cast<std::size_t>(quantile * (latencies.size() - 1))]));
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bench::Suite suite{argc, argv};
+
+  for (const std::size_t batch : {1, 16, 64}) {
+    const auto suffix = "/batch=" + std::to_string(batch);
+    Measure<SpscQueue<std::uint64_t, Capacity>>(suite, "queue/SpscQueue/threads=2" + suffix, 1, 1, batch);
+  }
+  for (const std::size_t threads : {2, 4, 8, 16, 32}) {
+    const auto producers = threads / 2;
+    const auto prefix = "/threads=" + std::to_string(threads);
+    Measure<LockedQueue<std::uint64_t>>(suite, "queue/LockedQueue" + prefix, producers, threads - producers, 1);
+    for (const std::size_t batch : {1, 16, 64}) {
+      Measure<MpmcQueue<std::uint64_t, Capacity>>(suite, "queue/MpmcQueue" + prefix + "/batch=" + std::to_string(batch),
+                                                  producers, threads - producers, batch);
+    }
+  }
+
+  return suite.Finish();
+}
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../slice/Slice.hpp"
+#include "../sort/RadixSort.hpp"
+#include "Bench.hpp"
+
+namespace {
+
+// Comparison sorts get slow on one core past this size.
+constexpr std::size_t ComparisonSortLimit = 10'000'000;
+
+std::vector<std::size_t> ThreadCounts() {
+  std::vector<std::size_t> counts{1};
+  for (std::size_t threads = 2; threads <= std::thread::hardware_concurrency(); threads *= 2) {
+    counts.push_back(threads);
+  }
+  return counts;
+}
+
+template <typename Key>
+std::vector<Key> RandomKeys(std::size_t size) {
+  std::mt19937_64 random{size};
+  std::vector<Key> keys(size);
+  for (auto& key : keys) {
+    if constexpr (std::is_floating_point_v<Key>) {
+      key = static_cast<Key>(std::normal_distribution<double>{}(random));
+    } else {
+      key = static_cast<Key>(random());
+    }
+  }
+  return keys;
+}
+
+template <typename Key>
+void ArgsortBenchmarks(bench::Suite& suite, const std::string& type, std::size_t size) {
+  const auto keys = RandomKeys<Key>(size);
+  const Span<const Key> key_span{keys.data(), keys.size()};
+  std::vector<std::uint32_t> permutation(size);
+  const Span<std::uint32_t> permutation_span{permutation.data(), permutation.size()};
+  const auto prefix = "argsort/" + type + "/n=" + std::to_string(size);
+
+  if (size <= ComparisonSortLimit) {
+    suite.Run(prefix + "/std_stable_sort", size, [&] {
+      std::iota(permutation.begin(), permutation.end(), 0);
+      std::stable_sort(permutation.begin(), permutation.end(), [&](std::uint32_t lhs, std::uint32_t rhs) {
+        return keys[lhs] < keys[rhs];
+      });
+    });
+  }
+  for (const auto threads : ThreadCounts()) {
+    suite.Run(prefix + "/RadixArgsort/threads=" + std::to_string(threads), size, [&] {
+      RadixArgsort(key_span, permutation_span, threads);
+    });
+  }
+}
+
+// Records of four 32-bit fields sorted by their first field, reached through
+// a stride-4 Slice, against std::sort over whole records.
+void RecordBenchmarks(bench::Suite& suite, std::size_t size) {
+  using Record = std::array<std::uint32_t, 4>;
+  const auto keys = RandomKeys<std::uint32_t>(size);
+  std::vector<Record> initial(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    initial[i] = {keys[i], static_cast<std::uint32_t>(i), 0, 0};
+  }
+  std::vector<Record> records(size);
+  const auto prefix = "records/n=" + std::to_string(size);
+
+  if (size <= ComparisonSortLimit) {
+    suite.Run(prefix + "/std_sort", size, [&] {
+      records = initial;
+      std::sort(records.begin(), records.end(), [](const Record& lhs, const Record& rhs) { return lhs[0] < rhs[0]; });
+    });
+  }
+  for (const auto threads : ThreadCounts()) {
+    suite.Run(prefix + "/ParallelRadixSort/threads=" + std::to_string(threads), size, [&] {
+      records = initial;
+      auto* fields = records.front().data();
+      using Field = Slice<std::uint32_t, dynamic_extent, 4>;
+      ParallelRadixSort(threads, Field{fields, size}, Field{fields + 1, size}, Field{fields + 2, size}, Field{fields + 3, size});
+    });
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bench::Suite suite{argc, argv};
+  for (const std::size_t size : {10'000, 100'000, 1'000'000, 10'000'000, 100'000'000}) {
+    ArgsortBenchmarks<std::uint32_t>(suite, "u32", size);
+    ArgsortBenchmarks<double>(suite, "f64", size);
+    if (size <= ComparisonSortLimit) {
+      RecordBenchmarks(suite, size);
+    }
+  }
+  return suite.Finish();
+}
@@ -0,0 +1,104 @@
+#include <cstddef>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../regex/Regex.hpp"
+#include "Bench.hpp"
+
+namespace {
+
+constexpr std::size_t LogSize = 8 << 20;
+
+// Synthetic service log, mostly INFO lines with a few warnings and errors.
+std::string MakeLog() {
+  static constexpr const char* levels[] = {"INFO", "INFO", "INFO", "INFO", "INFO", "INFO", "INFO", "INFO", "WARN", "ERROR"};
+  static constexpr const char* events[] = {"request served", "cache miss", "disk nearly full", "upstream timeout",
+                                           "retrying request", "connection reset"};
+  std::mt19937_64 random{2024};
+  std::string log;
+  log.reserve(LogSize + 256);
+  while (log.size() < LogSize) {
+    log += "2024-05-01T12:";
+    log += std::to_string(10 + random() % 50);
+    log += ':';
+    log += std::to_string(10 + random() % 50);
+    log += ' ';
+    log += levels[random() % std::size(levels)];
+    log += " service=api id=";
+    log += std::to_string(random() % 1'000'000);
+    log += ' ';
+    log += events[random() % std::size(events)];
+    log += " took ";
+    log += std::to_string(random() % (random() % 64 == 0 ? 20'000 : 900));
+    log += "ms\n";
+  }
+  return log;
+}
+
+std::vector<std::string_view> SplitLines(std::string_view log) {
+  std::vector<std::string_view> lines;
+  for (std::size_t begin = 0; begin < log.size();) {
+    const auto end = log.find('\n', begin);
+    lines.push_back(log.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  return lines;
+}
+
+// Counts lines containing a match, with std::regex and with CompiledRegex.
+template <auto pattern>
+void LineBenchmarks(bench::Suite& suite, const std::string& name, const std::string& log,
+                    const std::vector<std::string_view>& lines) {
+  const std::regex regex{std::string{std::string_view{pattern}}, std::regex::optimize};
+  std::size_t count = 0;
+  suite.Run("lines/" + name + "/std_regex", log.size(), [&] {
+    count = 0;
+    for (const auto line : lines) {
+      count += std::regex_search(line.begin(), line.end(), regex);
+    }
+    bench::DoNotOptimize(count);
+  });
+  const auto compiled = "lines/" + name + "/CompiledRegex";
+  suite.Run(compiled, log.size(), [&] {
+    count = 0;
+    for (const auto line : lines) {
+      count += RegexSearch<pattern>(line);
+    }
+    bench::DoNotOptimize(count);
+  });
+  suite.Metric(compiled, "matching_lines", static_cast<double>(count));
+}
+
+// Searches the whole log for a pattern that never matches, so every byte is
+// looked at.
+template <auto pattern>
+void BufferBenchmarks(bench::Suite& suite, const std::string& name, const std::string& log) {
+  const std::regex regex{std::string{std::string_view{pattern}}, std::regex::optimize};
+  bool found = false;
+  suite.Run("buffer/" + name + "/std_regex", log.size(), [&] {
+    found = std::regex_search(log, regex);
+    bench::DoNotOptimize(found);
+  });
+  suite.Run("buffer/" + name + "/CompiledRegex", log.size(), [&] {
+    found = RegexSearch<pattern>(log);
+    bench::DoNotOptimize(found);
+  });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bench::Suite suite{argc, argv};
+  const auto log = MakeLog();
+  const auto lines = SplitLines(log);
+
+  LineBenchmarks<"ERROR .*timeout"_cstr>(suite, "prefix", log, lines);
+  LineBenchmarks<"took [0-9][0-9][0-9][0-9]+ms"_cstr>(suite, "slow", log, lines);
+  LineBenchmarks<"(WARN|ERROR).*disk"_cstr>(suite, "alternation", log, lines);
+  BufferBenchmarks<"ERROR [a-z ]+deadlock"_cstr>(suite, "prefix", log);
+  BufferBenchmarks<"[A-Z]+ service=db"_cstr>(suite, "no_prefix", log);
+  return suite.Finish();
+}
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../slice/Rolling.hpp"
+#include "Bench.hpp"
+
+namespace {
+
+// Every window aggregated from scratch, the O(n * w) baseline.
+template <typename Func>
+void Naive(const std::vector<double>& series, std::size_t window, std::vector<double>& out, Func&& aggregate) {
+  for (std::size_t k = 0; k < out.size(); ++k) {
+    out[k] = aggregate(series.data() + k, series.data() + k + window);
+  }
+  bench::ClobberMemory();
+}
+
+void Benchmarks(bench::Suite& suite, std::size_t size, std::size_t window) {
+  std::mt19937_64 random{size};
+  std::vector<double> series(size);
+  double level = 100.0;
+  for (auto& value : series) {
+    level += std::normal_distribution<double>{}(random);
+    value = level;
+  }
+  std::vector<double> out(size - window + 1);
+  const auto windows = Windows(Span<const double>{series.data(), series.size()}, window);
+  const Span<double> out_span{out.data(), out.size()};
+  const auto prefix = "n=" + std::to_string(size) + "/w=" + std::to_string(window) + "/";
+  // Naive aggregation is quadratic, keep it to sizes that finish.
+  const bool naive = size * window <= std::size_t{1} << 30;
+
+  if (naive) {
+    suite.Run(prefix + "sum/naive", out.size(), [&] {
+      Naive(series, window, out, [](const double* first, const double* last) {
+        double sum = 0;
+        for (; first != last; ++first) {
+          sum += *first;
+        }
+        return sum;
+      });
+    });
+  }
+  suite.Run(prefix + "sum/RollingSum", out.size(), [&] {
+    RollingSum(windows, out_span);
+    bench::ClobberMemory();
+  });
+  suite.Run(prefix + "mean/RollingMean", out.size(), [&] {
+    RollingMean(windows, out_span);
+    bench::ClobberMemory();
+  });
+  if (naive) {
+    suite.Run(prefix + "min/naive", out.size(), [&] {
+      Naive(series, window, out, [](const double* first, const double* last) { return *std::min_element(first, last); });
+    });
+  }
+  suite.Run(prefix + "min/RollingMin", out.size(), [&] {
+    RollingMin(windows, out_span);
+    bench::ClobberMemory();
+  });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bench::Suite suite{argc, argv};
+  for (const std::size_t size : {100'000, 10'000'000}) {
+    for (const std::size_t window : {16, 256, 4096}) {
+      Benchmarks(suite, size, window);
+    }
+  }
+  return suite.Finish();
+}
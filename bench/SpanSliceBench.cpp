@@ -0,0 +1,245 @@
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../slice/Prefetch.hpp"
+#include "../slice/Slice.hpp"
+#include "../slice/StrideDispatch.hpp"
+#include "../span/Span.hpp"
+#include "Bench.hpp"
+
+namespace {
+
+using Value = std::int32_t;
+
+// 64 KiB of values: iteration benchmarks run out of L2.
+constexpr std::size_t IterationSize = 16 * 1024;
+// Larger than the last level cache, for the strided and prefetch runs.
+constexpr std::size_t LargeSize = 16 * 1024 * 1024;
+
+// The layout_stride mapping of std::mdspan reduced to what a loop sees.
+struct StridedPointer {
+  const Value* data;
+  std::ptrdiff_t stride;
+
+  const Value& operator[](std::size_t index) const noexcept {
+    return data[static_cast<std::ptrdiff_t>(index) * stride];
+  }
+};
+
+template <typename Range>
+std::int64_t SumRange(const Range& range) noexcept {
+  std::int64_t sum = 0;
+  for (const auto value : range) {
+    sum += value;
+  }
+  return sum;
+}
+
+// Back to front, the loop a reverse scan or a backward merge runs.
+template <typename Range>
+std::int64_t SumReverse(const Range& range) noexcept {
+  std::int64_t sum = 0;
+  for (auto iter = range.end(); iter != range.begin();) {
+    --iter;
+    sum += *iter;
+  }
+  return sum;
+}
+
+template <typename Range>
+std::int64_t SumIndexed(const Range& range, std::size_t size) noexcept {
+  std::int64_t sum = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    sum += range[i];
+  }
+  return sum;
+}
+
+template <typename Range>
+std::int64_t SumReversed(const Range& range) noexcept {
+  std::int64_t sum = 0;
+  for (auto it = range.rbegin(); it != range.rend(); ++it) {
+    sum += *it;
+  }
+  return sum;
+}
+
+void IterationBenchmarks(bench::Suite& suite, std::vector<Value>& values) {
+  const Value* data = values.data();
+  const std::span<const Value> std_span{values};
+  const std::span<const Value, IterationSize> std_static_span{data, IterationSize};
+  const Span<const Value> span{data, IterationSize};
+  const Span<const Value, IterationSize> static_span{data, IterationSize};
+  const Slice<const Value, dynamic_extent, 1> slice{data, IterationSize};
+  const Slice<const Value, IterationSize, 1> static_slice{data, IterationSize};
+  const Slice<const Value, dynamic_extent, dynamic_stride> dynamic_slice{data, IterationSize, 1};
+
+  suite.Run("iterate/raw_pointer", IterationSize, [&] {
+    std::int64_t sum = 0;
+    for (const Value* it = data; it != data + IterationSize; ++it) {
+      sum += *it;
+    }
+    bench::DoNotOptimize(sum);
+  });
+  suite.Run("iterate/std_span", IterationSize, [&] { bench::DoNotOptimize(SumRange(std_span)); });
+  suite.Run("iterate/std_span_static", IterationSize, [&] { bench::DoNotOptimize(SumRange(std_static_span)); });
+  suite.Run("iterate/Span", IterationSize, [&] { bench::DoNotOptimize(SumRange(span)); });
+  suite.Run("iterate/Span_static", IterationSize, [&] { bench::DoNotOptimize(SumRange(static_span)); });
+  suite.Run("iterate/Slice_stride1", IterationSize, [&] { bench::DoNotOptimize(SumRange(slice)); });
+  suite.Run("iterate/Slice_static", IterationSize, [&] { bench::DoNotOptimize(SumRange(static_slice)); });
+  suite.Run("iterate/Slice_dynamic_stride", IterationSize, [&] { bench::DoNotOptimize(SumRange(dynamic_slice)); });
+  suite.Run("iterate/DispatchStride", IterationSize, [&] {
+    bench::DoNotOptimize(DispatchStride(dynamic_slice, [](auto dispatched) { return SumRange(dispatched); }));
+  });
+
+  suite.Run("index/raw_pointer", IterationSize, [&] { bench::DoNotOptimize(SumIndexed(data, IterationSize)); });
+  suite.Run("index/std_span", IterationSize, [&] { bench::DoNotOptimize(SumIndexed(std_span, std_span.size())); });
+  suite.Run("index/Span", IterationSize, [&] { bench::DoNotOptimize(SumIndexed(span, span.Size())); });
+  suite.Run("index/Span_static", IterationSize, [&] { bench::DoNotOptimize(SumIndexed(static_span, static_span.Size())); });
+  suite.Run("index/Slice_stride1", IterationSize, [&] { bench::DoNotOptimize(SumIndexed(slice, slice.Size())); });
+  suite.Run("index/Slice_dynamic_stride", IterationSize, [&] {
+    bench::DoNotOptimize(SumIndexed(dynamic_slice, dynamic_slice.Size()));
+  });
+
+  suite.Run("reverse/raw_pointer", IterationSize, [&] {
+    std::int64_t sum = 0;
+    for (const Value* it = data + IterationSize; it != data;) {
+      sum += *--it;
+    }
+    bench::DoNotOptimize(sum);
+  });
+  suite.Run("reverse/std_span", IterationSize, [&] { bench::DoNotOptimize(SumReversed(std_span)); });
+  suite.Run("reverse/Span", IterationSize, [&] { bench::DoNotOptimize(SumReversed(span)); });
+  suite.Run("reverse/Slice_stride1", IterationSize, [&] { bench::DoNotOptimize(SumReversed(slice)); });
+  suite.Run("reverse/Slice_dynamic_stride", IterationSize, [&] { bench::DoNotOptimize(SumReversed(dynamic_slice)); });
+}
+
+template <std::ptrdiff_t stride>
+void StrideBenchmarks(bench::Suite& suite, const std::vector<Value>& values) {
+  const Value* data = values.data();
+  const std::size_t count = values.size() / stride;
+  const std::string suffix = "/stride=" + std::to_string(stride);
+
+  suite.Run("strided/raw_pointer" + suffix, count, [&] {
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      sum += data[i * stride];
+    }
+    bench::DoNotOptimize(sum);
+  });
+  suite.Run("strided/layout_stride" + suffix, count, [&] {
+    bench::DoNotOptimize(SumIndexed(StridedPointer{data, stride}, count));
+  });
+  suite.Run("strided/Slice_static_stride" + suffix, count, [&] {
+    bench::DoNotOptimize(SumRange(Slice<const Value, dynamic_extent, stride>{data, count}));
+  });
+  suite.Run("strided/Slice_dynamic_stride" + suffix, count, [&] {
+    bench::DoNotOptimize(SumRange(Slice<const Value, dynamic_extent, dynamic_stride>{data, count, stride}));
+  });
+  suite.Run("strided/DispatchStride" + suffix, count, [&] {
+    const Slice<const Value, dynamic_extent, dynamic_stride> slice{data, count, stride};
+    bench::DoNotOptimize(DispatchStride(slice, [](auto dispatched) { return SumRange(dispatched); }));
+  });
+  suite.Run("strided/Slice_Skip" + suffix, count, [&] {
+    const Slice<const Value, dynamic_extent, 1> slice{data, count * stride};
+    bench::DoNotOptimize(SumRange(slice.Skip<stride>()));
+  });
+}
+
+// Cost of building views: every item creates one subview and reads its
+// first element, so the loop is dominated by the view arithmetic.
+void SubviewBenchmarks(bench::Suite& suite, const std::vector<Value>& values) {
+  const Value* data = values.data();
+  const Span<const Value> span{data, IterationSize};
+  const Slice<const Value, dynamic_extent, dynamic_stride> slice{data, IterationSize, 1};
+  constexpr std::size_t count = IterationSize / 2;
+
+  suite.Run("subview/Span_First", count, [&] {
+    std::int64_t sum = 0;
+    for (std::size_t i = 1; i <= count; ++i) {
+      sum += span.First(i).Back();
+    }
+    bench::DoNotOptimize(sum);
+  });
+  suite.Run("subview/Span_Last", count, [&] {
+    std::int64_t sum = 0;
+    for (std::size_t i = 1; i <= count; ++i) {
+      sum += span.Last(i).Front();
+    }
+    bench::DoNotOptimize(sum);
+  });
+  suite.Run("subview/std_span_subspan", count, [&] {
+    const std::span<const Value> std_span{data, IterationSize};
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      sum += std_span.subspan(i).front();
+    }
+    bench::DoNotOptimize(sum);
+  });
+  suite.Run("subview/Slice_DropFirst", count, [&] {
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      sum += slice.DropFirst(i)[0];
+    }
+    bench::DoNotOptimize(sum);
+  });
+  suite.Run("subview/Slice_Last", count, [&] {
+    std::int64_t sum = 0;
+    for (std::size_t i = 1; i <= count; ++i) {
+      sum += slice.Last(i)[0];
+    }
+    bench::DoNotOptimize(sum);
+  });
+  suite.Run("subview/Slice_Skip", count, [&] {
+    std::int64_t sum = 0;
+    for (std::size_t i = 1; i <= count; ++i) {
+      const auto skipped = slice.Skip(static_cast<std::ptrdiff_t>(i % 7 + 1));
+      sum += skipped[skipped.Size() - 1];
+    }
+    bench::DoNotOptimize(sum);
+  });
+}
+
+// Software prefetch over strided slices of an array larger than the cache,
+// sweeping the distance in elements, front to back and back to front.
+// Distance 0 is the plain loop.
+void PrefetchBenchmarks(bench::Suite& suite, const std::vector<Value>& values) {
+  for (const std::ptrdiff_t stride : {1, 4, 16, 64}) {
+    const std::size_t count = values.size() / static_cast<std::size_t>(stride);
+    const Slice<const Value, dynamic_extent, dynamic_stride> slice{values.data(), count, stride};
+    for (const std::size_t distance : {0, 2, 8, 32, 128, 512}) {
+      const auto name = "prefetch/stride=" + std::to_string(stride) + "/distance=" + std::to_string(distance);
+      if (distance == 0) {
+        suite.Run(name, count, [&] { bench::DoNotOptimize(SumRange(slice)); });
+        suite.Run(name + "/reverse", count, [&] { bench::DoNotOptimize(SumReverse(slice)); });
+      } else {
+        suite.Run(name, count, [&] { bench::DoNotOptimize(SumRange(Prefetched(slice, distance))); });
+        suite.Run(name + "/reverse", count, [&] { bench::DoNotOptimize(SumReverse(Prefetched(slice, distance))); });
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bench::Suite suite{argc, argv};
+
+  std::vector<Value> values(IterationSize);
+  std::iota(values.begin(), values.end(), 0);
+  IterationBenchmarks(suite, values);
+  SubviewBenchmarks(suite, values);
+
+  std::vector<Value> large(LargeSize);
+  std::iota(large.begin(), large.end(), 0);
+  StrideBenchmarks<2>(suite, large);
+  StrideBenchmarks<4>(suite, large);
+  StrideBenchmarks<16>(suite, large);
+  PrefetchBenchmarks(suite, large);
+
+  return suite.Finish();
+}
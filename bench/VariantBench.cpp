@@ -0,0 +1,129 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "../variant/CompactVariant.hpp"
+#include "Bench.hpp"
+
+namespace {
+
+constexpr std::size_t ElementCount = 1 << 20;
+
+struct Circle {
+  float radius;
+};
+
+struct Rect {
+  float width;
+  float height;
+};
+
+struct Triangle {
+  float base;
+  float height;
+  float skew;
+};
+
+struct Idle {};
+struct Pending {};
+
+struct Area {
+  double operator()(const Circle& circle) const noexcept {
+    return 3.14159265 * circle.radius * circle.radius;
+  }
+  double operator()(const Rect& rect) const noexcept {
+    return rect.width * rect.height;
+  }
+  double operator()(const Triangle& triangle) const noexcept {
+    return 0.5 * triangle.base * triangle.height;
+  }
+};
+
+struct Weight {
+  double operator()(bool done) const noexcept {
+    return done ? 2.0 : 1.0;
+  }
+  double operator()(Idle) const noexcept {
+    return 0.0;
+  }
+  double operator()(Pending) const noexcept {
+    return 0.5;
+  }
+};
+
+template <typename Variant>
+std::vector<Variant> MakeShapes() {
+  std::mt19937_64 random{ElementCount};
+  std::vector<Variant> shapes;
+  shapes.reserve(ElementCount);
+  for (std::size_t i = 0; i < ElementCount; ++i) {
+    const auto size = static_cast<float>(random() % 100) / 10.0f;
+    switch (random() % 3) {
+      case 0: shapes.emplace_back(Circle{size}); break;
+      case 1: shapes.emplace_back(Rect{size, size + 1}); break;
+      default: shapes.emplace_back(Triangle{size, size + 2, 0.5f}); break;
+    }
+  }
+  return shapes;
+}
+
+template <typename Variant>
+std::vector<Variant> MakeStates() {
+  std::mt19937_64 random{ElementCount};
+  std::vector<Variant> states;
+  states.reserve(ElementCount);
+  for (std::size_t i = 0; i < ElementCount; ++i) {
+    switch (random() % 4) {
+      case 0: states.emplace_back(Idle{}); break;
+      case 1: states.emplace_back(Pending{}); break;
+      default: states.emplace_back(random() % 2 == 0); break;
+    }
+  }
+  return states;
+}
+
+// Sums the visitor over every element with std::visit and with Visit, each
+// run reporting the size of one element.
+template <typename Compact, typename Std, typename Visitor>
+void VisitBenchmarks(bench::Suite& suite, const std::string& name, const std::vector<Compact>& compact,
+                     const std::vector<Std>& std_variants, Visitor visitor) {
+  const auto std_name = "visit/" + name + "/std_variant";
+  suite.Run(std_name, std_variants.size(), [&] {
+    double sum = 0;
+    for (const auto& value : std_variants) {
+      sum += std::visit(visitor, value);
+    }
+    bench::DoNotOptimize(sum);
+  });
+  suite.Metric(std_name, "sizeof", static_cast<double>(sizeof(Std)));
+
+  const auto compact_name = "visit/" + name + "/CompactVariant";
+  suite.Run(compact_name, compact.size(), [&] {
+    double sum = 0;
+    for (const auto& value : compact) {
+      sum += value.Visit(visitor);
+    }
+    bench::DoNotOptimize(sum);
+  });
+  suite.Metric(compact_name, "sizeof", static_cast<double>(sizeof(Compact)));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bench::Suite suite{argc, argv};
+
+  using Shape = CompactVariant<type_tuples::TTuple<Circle, Rect, Triangle>>;
+  using StdShape = std::variant<Circle, Rect, Triangle>;
+  VisitBenchmarks(suite, "shapes", MakeShapes<Shape>(), MakeShapes<StdShape>(), Area{});
+
+  // One byte with the bool niche, against two for std::variant.
+  using State = CompactVariant<type_tuples::TTuple<bool, Idle, Pending>>;
+  using StdState = std::variant<bool, Idle, Pending>;
+  static_assert(State::UsesNiche());
+  VisitBenchmarks(suite, "niche", MakeStates<State>(), MakeStates<StdState>(), Weight{});
+  return suite.Finish();
+}
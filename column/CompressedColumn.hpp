@@ -0,0 +1,432 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+#include "../span/Span.hpp"
+
+namespace detail {
+
+// Every column keeps this many zero bytes after its last block, so decoders may
+// always load a whole 64-bit word, or 16 bytes for SIMD, without checking for
+// the end of the buffer.
+inline constexpr std::size_t ColumnPadding = 16;
+
+inline std::uint64_t LoadWord(const std::uint8_t* data) noexcept {
+  std::uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+inline void OrWord(std::uint8_t* data, std::uint64_t bits) noexcept {
+  std::uint64_t word = LoadWord(data) | bits;
+  std::memcpy(data, &word, sizeof(word));
+}
+
+template <std::integral T>
+constexpr auto ZigZagEncode(T value) noexcept {
+  using U = std::make_unsigned_t<T>;
+  if constexpr (std::is_signed_v<T>) {
+    return static_cast<U>((static_cast<U>(value) << 1) ^ static_cast<U>(value >> (sizeof(T) * 8 - 1)));
+  } else {
+    return static_cast<U>((value << 1) ^ (U{0} - (value >> (sizeof(T) * 8 - 1))));
+  }
+}
+
+template <std::unsigned_integral U>
+constexpr U ZigZagDecode(U value) noexcept {
+  return static_cast<U>((value >> 1) ^ (U{0} - (value & 1)));
+}
+
+// Values are packed LSB-first, so every group of 8 values starts on a byte
+// boundary and the offsets inside a group are compile-time constants.
+template <std::integral T, unsigned width>
+void UnpackBits(const std::uint8_t* in, std::make_unsigned_t<T> base, T* out, std::size_t count) noexcept {
+  using U = std::make_unsigned_t<T>;
+  constexpr std::uint64_t mask = width == 0 ? 0 : (~std::uint64_t{0} >> (64 - width));
+
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8, in += width) {
+    [&]<std::size_t... js>(std::index_sequence<js...>) {
+      ((out[i + js] = static_cast<T>(static_cast<U>(
+          base + ((LoadWord(in + js * width / 8) >> (js * width % 8)) & mask)))), ...);
+    }(std::make_index_sequence<8>{});
+  }
+  for (std::size_t j = 0; i < count; ++i, ++j) {
+    const auto bit = j * width;
+    out[i] = static_cast<T>(static_cast<U>(base + ((LoadWord(in + bit / 8) >> (bit % 8)) & mask)));
+  }
+}
+
+#if defined(__SSE4_1__)
+// How to split the next 8 bytes of a LEB128 stream, indexed by their
+// continuation bits: the complete varints of one or two bytes at its start,
+// the bytes they take, and a shuffle moving each into a 16-bit lane.
+struct VarintGroup {
+  std::uint8_t count;
+  std::uint8_t bytes;
+  alignas(16) std::array<std::uint8_t, 16> shuffle;
+};
+
+inline constexpr auto VarintGroups = [] {
+  std::array<VarintGroup, 256> groups{};
+  for (unsigned mask = 0; mask < 256; ++mask) {
+    auto& group = groups[mask];
+    group.shuffle.fill(0x80);
+    unsigned position = 0;
+    while (position < 8) {
+      const bool continues = (mask >> position) & 1;
+      if (continues && (position + 1 == 8 || ((mask >> (position + 1)) & 1))) {
+        break;
+      }
+      group.shuffle[2 * group.count] = static_cast<std::uint8_t>(position);
+      if (continues) {
+        group.shuffle[2 * group.count + 1] = static_cast<std::uint8_t>(position + 1);
+      }
+      position += continues ? 2 : 1;
+      ++group.count;
+    }
+    group.bytes = static_cast<std::uint8_t>(position);
+  }
+  return groups;
+}();
+
+// Writes the values of a group starting at byte offset of bytes to out[0, 8).
+template <typename T>
+inline void ExpandVarintGroup(__m128i bytes, const VarintGroup& group, unsigned offset, T* out) noexcept {
+  // Shifting the indices keeps the 0x80 entries negative, so they still yield 0.
+  const __m128i shuffle = _mm_add_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(group.shuffle.data())),
+                                       _mm_set1_epi8(static_cast<char>(offset)));
+  const __m128i lanes = _mm_shuffle_epi8(bytes, shuffle);
+  const __m128i values = _mm_or_si128(_mm_and_si128(lanes, _mm_set1_epi16(0x7f)),
+                                      _mm_and_si128(_mm_srli_epi16(lanes, 1), _mm_set1_epi16(0x3f80)));
+  auto* store = reinterpret_cast<__m128i*>(out);
+  if constexpr (sizeof(T) == 8) {
+    _mm_storeu_si128(store, _mm_cvtepu16_epi64(values));
+    _mm_storeu_si128(store + 1, _mm_cvtepu16_epi64(_mm_srli_si128(values, 4)));
+    _mm_storeu_si128(store + 2, _mm_cvtepu16_epi64(_mm_srli_si128(values, 8)));
+    _mm_storeu_si128(store + 3, _mm_cvtepu16_epi64(_mm_srli_si128(values, 12)));
+  } else if constexpr (sizeof(T) == 4) {
+    _mm_storeu_si128(store, _mm_cvtepu16_epi32(values));
+    _mm_storeu_si128(store + 1, _mm_cvtepu16_epi32(_mm_srli_si128(values, 8)));
+  } else {
+    _mm_storeu_si128(store, values);
+  }
+}
+
+// Decodes the one- and two-byte varints at the start of in, two groups from
+// one 16-byte load, into out, which has room for at least 8 values. Returns
+// the number decoded, 0 when the first varint is longer.
+template <typename T>
+inline std::size_t DecodeShortVarints(const std::uint8_t*& in, T* out, std::size_t room) noexcept {
+  const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  const auto mask = static_cast<unsigned>(_mm_movemask_epi8(bytes));
+  const auto& first = VarintGroups[mask & 0xff];
+  ExpandVarintGroup(bytes, first, 0, out);
+  std::size_t decoded = first.count;
+  unsigned offset = first.bytes;
+  if (decoded != 0 && decoded + 8 <= room) {
+    const auto& second = VarintGroups[(mask >> offset) & 0xff];
+    ExpandVarintGroup(bytes, second, offset, out + decoded);
+    decoded += second.count;
+    offset += second.bytes;
+  }
+  in += offset;
+  return decoded;
+}
+#endif
+
+#if defined(__AVX2__)
+// deltas[j] = sum of ZigZagDecode(deltas[k]) for k <= j, four lanes at a time,
+// then the carry from the previous four. Returns how many were done.
+inline std::size_t ZigZagPrefixSums(std::uint64_t* deltas, std::size_t count) noexcept {
+  std::size_t j = 0;
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi64x(1);
+  __m256i carry = zero;
+  for (; j + 4 <= count; j += 4) {
+    auto* lane = reinterpret_cast<__m256i*>(deltas + j);
+    __m256i sums = _mm256_loadu_si256(lane);
+    sums = _mm256_xor_si256(_mm256_srli_epi64(sums, 1), _mm256_sub_epi64(zero, _mm256_and_si256(sums, one)));
+    sums = _mm256_add_epi64(sums, _mm256_blend_epi32(_mm256_permute4x64_epi64(sums, 0x90), zero, 0x03));
+    sums = _mm256_add_epi64(sums, _mm256_permute2x128_si256(sums, sums, 0x08));
+    sums = _mm256_add_epi64(sums, carry);
+    _mm256_storeu_si256(lane, sums);
+    carry = _mm256_permute4x64_epi64(sums, 0xFF);
+  }
+  return j;
+}
+#endif
+
+} // namespace detail
+
+
+// FrameOfReference
+//
+// Block layout: [bit width : 1][base : sizeof(T)][values - base, bit-packed].
+// Blocks whose range needs more than 56 bits are stored verbatim.
+struct FrameOfReference {
+  static constexpr unsigned MaxPackedWidth = 56;
+
+  template <std::integral T>
+  static void Encode(Span<const T> values, std::vector<std::uint8_t>& out) {
+    using U = std::make_unsigned_t<T>;
+    assert(!values.Empty());
+
+    const auto [min, max] = std::minmax_element(values.begin(), values.end());
+    const auto base = static_cast<U>(*min);
+    const auto width = static_cast<unsigned>(std::bit_width(static_cast<U>(static_cast<U>(*max) - base)));
+
+    if (width > MaxPackedWidth) {
+      out.push_back(static_cast<std::uint8_t>(sizeof(T) * 8));
+      const auto offset = out.size();
+      out.resize(offset + values.SizeBytes());
+      std::memcpy(out.data() + offset, values.Data(), values.SizeBytes());
+      return;
+    }
+
+    out.push_back(static_cast<std::uint8_t>(width));
+    auto offset = out.size();
+    out.resize(offset + sizeof(U));
+    std::memcpy(out.data() + offset, &base, sizeof(U));
+
+    offset = out.size();
+    out.resize(offset + (values.Size() * width + 7) / 8 + detail::ColumnPadding);
+    for (std::size_t i = 0; i < values.Size(); ++i) {
+      const auto bit = i * width;
+      detail::OrWord(out.data() + offset + bit / 8,
+                     static_cast<std::uint64_t>(static_cast<U>(static_cast<U>(values[i]) - base)) << (bit % 8));
+    }
+    out.resize(out.size() - detail::ColumnPadding);
+  }
+
+  template <std::integral T>
+  static void Decode(const std::uint8_t* in, Span<T> out) noexcept {
+    using U = std::make_unsigned_t<T>;
+    using Unpacker = void (*)(const std::uint8_t*, U, T*, std::size_t) noexcept;
+
+    static constexpr auto unpackers = []<unsigned... widths>(std::integer_sequence<unsigned, widths...>) {
+      return std::array<Unpacker, sizeof...(widths)>{&detail::UnpackBits<T, widths>...};
+    }(std::make_integer_sequence<unsigned, std::min<unsigned>(MaxPackedWidth, sizeof(T) * 8) + 1>{});
+
+    const unsigned width = *in++;
+    if (width >= unpackers.size()) {
+      std::memcpy(out.Data(), in, out.SizeBytes());
+      return;
+    }
+
+    U base;
+    std::memcpy(&base, in, sizeof(U));
+    unpackers[width](in + sizeof(U), base, out.Data(), out.Size());
+  }
+};
+
+
+// DeltaVarint
+//
+// Block layout: LEB128 varints of zigzag(values[i] - values[i - 1]), the
+// first value is taken relative to zero. With SSE4.1, runs of one- and
+// two-byte varints, deltas below 8192, decode 16 input bytes at a time and
+// longer ones take the scalar loop; with AVX2 the prefix sum of 64-bit values
+// runs four lanes wide. Scans still decode about half as fast as
+// FrameOfReference, the codec to pick when scan throughput matters most.
+struct DeltaVarint {
+  template <std::integral T>
+  static void Encode(Span<const T> values, std::vector<std::uint8_t>& out) {
+    using U = std::make_unsigned_t<T>;
+
+    U previous = 0;
+    for (const auto value : values) {
+      const auto delta = static_cast<T>(static_cast<U>(static_cast<U>(value) - previous));
+      auto encoded = static_cast<std::uint64_t>(detail::ZigZagEncode(delta));
+      while (encoded >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(encoded | 0x80));
+        encoded >>= 7;
+      }
+      out.push_back(static_cast<std::uint8_t>(encoded));
+      previous = static_cast<U>(value);
+    }
+  }
+
+  template <std::integral T>
+  static void Decode(const std::uint8_t* in, Span<T> out) noexcept {
+    using U = std::make_unsigned_t<T>;
+    constexpr std::uint64_t continuation_bits = 0x8080808080808080ULL;
+
+    const auto count = out.Size();
+    auto* deltas = out.Data();
+
+    std::size_t i = 0;
+    while (i < count) {
+#if defined(__SSE4_1__)
+      if constexpr (sizeof(T) >= 2) {
+        if (i + 8 <= count) {
+          const auto decoded = detail::DecodeShortVarints(in, deltas + i, count - i);
+          if (decoded != 0) {
+            i += decoded;
+            continue;
+          }
+        }
+      }
+#endif
+      // Fast path: the next eight varints are all single-byte.
+      if (i + 8 <= count) {
+        const auto word = detail::LoadWord(in);
+        if ((word & continuation_bits) == 0) {
+          for (std::size_t j = 0; j < 8; ++j) {
+            deltas[i + j] = static_cast<T>(static_cast<std::uint8_t>(word >> (j * 8)));
+          }
+          i += 8;
+          in += 8;
+          continue;
+        }
+      }
+
+      std::uint64_t value = 0;
+      unsigned shift = 0;
+      while (*in & 0x80) {
+        value |= static_cast<std::uint64_t>(*in++ & 0x7f) << shift;
+        shift += 7;
+      }
+      value |= static_cast<std::uint64_t>(*in++) << shift;
+      deltas[i++] = static_cast<T>(value);
+    }
+
+    std::size_t j = 0;
+#if defined(__AVX2__)
+    if constexpr (sizeof(T) == 8) {
+      j = detail::ZigZagPrefixSums(reinterpret_cast<std::uint64_t*>(deltas), count);
+    }
+#endif
+    U previous = j == 0 ? 0 : static_cast<U>(deltas[j - 1]);
+    for (; j < count; ++j) {
+      previous = static_cast<U>(previous + detail::ZigZagDecode(static_cast<U>(deltas[j])));
+      deltas[j] = static_cast<T>(previous);
+    }
+  }
+};
+
+
+template <typename Codec, typename T>
+concept ColumnCodec = requires(Span<const T> values, std::vector<std::uint8_t>& out, const std::uint8_t* in, Span<T> chunk) {
+  Codec::template Encode<T>(values, out);
+  Codec::template Decode<T>(in, chunk);
+};
+
+
+// CompressedColumn
+//
+// Read-only column of integers split into blocks of block_size values, each
+// compressed independently. Random access costs a single block decode.
+template <std::integral T, typename Codec = FrameOfReference, std::size_t block_size = 128>
+requires (!std::same_as<T, bool>) && ColumnCodec<Codec, T> && (block_size > 0)
+class CompressedColumn {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using chunk_type = Span<T, block_size>;
+
+  CompressedColumn() = default;
+
+  explicit CompressedColumn(Span<const T> values)
+    : size_{values.Size()} {
+    offsets_.reserve(BlockCount() + 1);
+    for (std::size_t first = 0; first < size_; first += block_size) {
+      offsets_.push_back(data_.size());
+      Codec::template Encode<T>(values.Last(size_ - first).First(std::min(block_size, size_ - first)), data_);
+    }
+    offsets_.push_back(data_.size());
+    data_.resize(data_.size() + detail::ColumnPadding);
+    data_.shrink_to_fit();
+  }
+
+  static constexpr std::size_t BlockSize() noexcept {
+    return block_size;
+  }
+
+  constexpr std::size_t Size() const noexcept {
+    return size_;
+  }
+
+  constexpr bool Empty() const noexcept {
+    return size_ == 0;
+  }
+
+  constexpr std::size_t BlockCount() const noexcept {
+    return (size_ + block_size - 1) / block_size;
+  }
+
+  constexpr std::size_t BlockLength(std::size_t block) const noexcept {
+    assert(block < BlockCount());
+    return std::min(block_size, size_ - block * block_size);
+  }
+
+  std::size_t SizeBytes() const noexcept {
+    return data_.size() + offsets_.size() * sizeof(std::size_t);
+  }
+
+  Span<T> DecodeBlock(std::size_t block, chunk_type chunk) const noexcept {
+    assert(block < BlockCount());
+    const auto values = chunk.First(BlockLength(block));
+    Codec::template Decode<T>(data_.data() + offsets_[block], values);
+    return values;
+  }
+
+ private:
+  std::size_t size_ = 0;
+  std::vector<std::size_t> offsets_;
+  std::vector<std::uint8_t> data_;
+};
+
+
+// ColumnReader
+//
+// Owns the reusable chunk a column is decoded into and remembers which block
+// it holds, so sequential point lookups decode every block only once. Copies
+// carry their own chunk, so they stay valid after the original is gone.
+template <typename Column>
+class ColumnReader {
+ public:
+  using value_type = typename Column::value_type;
+
+  explicit ColumnReader(const Column& column) noexcept
+    : column_{&column} {
+  }
+
+  Span<const value_type> Block(std::size_t block) noexcept {
+    if (block != block_) {
+      length_ = column_->DecodeBlock(block, chunk_).Size();
+      block_ = block;
+    }
+    return {chunk_.data(), length_};
+  }
+
+  value_type operator[](std::size_t index) noexcept {
+    assert(index < column_->Size());
+    return Block(index / Column::BlockSize())[index % Column::BlockSize()];
+  }
+
+  template <typename Func>
+  void ForEachBlock(Func&& func) {
+    for (std::size_t block = 0; block < column_->BlockCount(); ++block) {
+      func(Block(block));
+    }
+  }
+
+ private:
+  const Column* column_;
+  std::size_t block_ = static_cast<std::size_t>(-1);
+  std::array<value_type, Column::BlockSize()> chunk_;
+  std::size_t length_ = 0;
+};
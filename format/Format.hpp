@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "../polymapper/FixedString.hpp"
+#include "../span/Span.hpp"
+
+namespace detail {
+
+// Placeholder grammar: "{}", "{:x}" for hexadecimal integers and "{:.N}" for
+// floating point values in fixed notation with N digits after the point.
+struct FormatSpec {
+  bool hex = false;
+  int precision = -1;
+};
+
+// Every placeholder is preceded by a literal chunk, the last piece only
+// carries the trailing literal.
+struct FormatPiece {
+  std::size_t literal_begin = 0;
+  std::size_t literal_size = 0;
+  FormatSpec spec;
+};
+
+template <std::size_t capacity>
+struct ParsedFormat {
+  std::array<char, capacity> literals{};
+  std::array<FormatPiece, capacity + 1> pieces{};
+  std::size_t literal_size = 0;
+  std::size_t piece_count = 0;
+};
+
+consteval FormatSpec ParseFormatSpec(std::string_view spec) {
+  if (spec.empty()) {
+    return {};
+  }
+  if (spec == ":x") {
+    return {true, -1};
+  }
+  if (spec.size() > 2 && spec.starts_with(":.")) {
+    int precision = 0;
+    for (const auto c : spec.substr(2)) {
+      if (c < '0' || c > '9') {
+        throw "format precision must be a number";
+      }
+      precision = precision * 10 + (c - '0');
+    }
+    return {false, precision};
+  }
+  throw "unsupported format spec";
+}
+
+template <std::size_t capacity>
+consteval ParsedFormat<capacity> ParseFormat(std::string_view pattern) {
+  ParsedFormat<capacity> result;
+  FormatPiece current{};
+
+  for (std::size_t i = 0; i < pattern.size(); ++i) {
+    const auto c = pattern[i];
+    if ((c == '{' || c == '}') && i + 1 < pattern.size() && pattern[i + 1] == c) {
+      result.literals[result.literal_size++] = c;
+      ++current.literal_size;
+      ++i;
+    } else if (c == '{') {
+      const auto close = pattern.find('}', i);
+      if (close == std::string_view::npos) {
+        throw "unterminated placeholder in format string";
+      }
+      current.spec = ParseFormatSpec(pattern.substr(i + 1, close - i - 1));
+      result.pieces[result.piece_count++] = current;
+      current = FormatPiece{};
+      current.literal_begin = result.literal_size;
+      i = close;
+    } else if (c == '}') {
+      throw "unmatched '}' in format string";
+    } else {
+      result.literals[result.literal_size++] = c;
+      ++current.literal_size;
+    }
+  }
+
+  result.pieces[result.piece_count++] = current;
+  return result;
+}
+
+constexpr std::size_t DecimalDigits(std::size_t value) noexcept {
+  std::size_t digits = 1;
+  while (value >= 10) {
+    value /= 10;
+    ++digits;
+  }
+  return digits;
+}
+
+template <FormatSpec spec, typename T>
+constexpr std::size_t MaxArgumentSize(const T& value) noexcept {
+  if constexpr (std::same_as<T, bool>) {
+    return 5;
+  } else if constexpr (std::same_as<T, char>) {
+    return 1;
+  } else if constexpr (std::integral<T>) {
+    return spec.hex ? sizeof(T) * 2 + 1 : std::numeric_limits<T>::digits10 + 2;
+  } else if constexpr (std::floating_point<T>) {
+    using Limits = std::numeric_limits<T>;
+    if constexpr (spec.precision < 0) {
+      // Sign, point, "e+" and the exponent around the shortest round-trip digits.
+      return Limits::max_digits10 + 4 + DecimalDigits(Limits::max_exponent10);
+    } else {
+      return Limits::max_exponent10 + 3 + spec.precision;
+    }
+  } else {
+    return std::string_view{value}.size();
+  }
+}
+
+inline bool WriteChars(const char* data, std::size_t size, char*& cursor, char* last) noexcept {
+  if (static_cast<std::size_t>(last - cursor) < size) {
+    return false;
+  }
+  std::memcpy(cursor, data, size);
+  cursor += size;
+  return true;
+}
+
+template <FormatSpec spec, typename T>
+bool WriteArgument(const T& value, char*& cursor, char* last) noexcept {
+  static_assert(!spec.hex || (std::integral<T> && !std::same_as<T, bool>), "{:x} needs an integer argument");
+  static_assert(spec.precision < 0 || std::floating_point<T>, "{:.N} needs a floating point argument");
+
+  if constexpr (std::same_as<T, bool>) {
+    return value ? WriteChars("true", 4, cursor, last) : WriteChars("false", 5, cursor, last);
+  } else if constexpr (std::same_as<T, char>) {
+    return WriteChars(&value, 1, cursor, last);
+  } else if constexpr (std::integral<T> || std::floating_point<T>) {
+    std::to_chars_result result;
+    if constexpr (std::integral<T>) {
+      result = std::to_chars(cursor, last, value, spec.hex ? 16 : 10);
+    } else if constexpr (spec.precision < 0) {
+      result = std::to_chars(cursor, last, value);
+    } else {
+      result = std::to_chars(cursor, last, value, std::chars_format::fixed, spec.precision);
+    }
+    if (result.ec != std::errc{}) {
+      return false;
+    }
+    cursor = result.ptr;
+    return true;
+  } else {
+    static_assert(std::convertible_to<const T&, std::string_view>, "unsupported format argument type");
+    const std::string_view string{value};
+    return WriteChars(string.data(), string.size(), cursor, last);
+  }
+}
+
+} // namespace detail
+
+
+// CompiledFormat
+//
+// Parses pattern at compile time into literal chunks and typed placeholders.
+// FormatTo writes into a caller-provided buffer without allocating and
+// returns the number of characters written, or nullopt if they do not fit.
+template <auto pattern>
+requires std::convertible_to<decltype(pattern), std::string_view>
+class CompiledFormat {
+ private:
+  static constexpr auto parsed_ = detail::ParseFormat<std::string_view{pattern}.size()>(std::string_view{pattern});
+
+  static constexpr auto literals_ = [] {
+    std::array<char, parsed_.literal_size> literals{};
+    std::copy_n(parsed_.literals.begin(), literals.size(), literals.begin());
+    return literals;
+  }();
+
+  static constexpr auto pieces_ = [] {
+    std::array<detail::FormatPiece, parsed_.piece_count> pieces{};
+    std::copy_n(parsed_.pieces.begin(), pieces.size(), pieces.begin());
+    return pieces;
+  }();
+
+  template <std::size_t index>
+  static bool WriteLiteral(char*& cursor, char* last) noexcept {
+    return detail::WriteChars(literals_.data() + pieces_[index].literal_begin, pieces_[index].literal_size, cursor, last);
+  }
+
+ public:
+  static constexpr std::size_t PlaceholderCount() noexcept {
+    return pieces_.size() - 1;
+  }
+
+  static constexpr std::size_t LiteralSize() noexcept {
+    return literals_.size();
+  }
+
+  // Upper bound of the formatted size, exact when every argument is a string.
+  template <typename... Args>
+  static constexpr std::size_t MaxSize(const Args&... args) noexcept {
+    static_assert(sizeof...(Args) == PlaceholderCount(), "argument count does not match the format string");
+    return [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+      return (LiteralSize() + ... + detail::MaxArgumentSize<pieces_[indices].spec>(args));
+    }(std::index_sequence_for<Args...>{});
+  }
+
+  template <typename... Args>
+  static std::optional<std::size_t> FormatTo(Span<char> out, const Args&... args) noexcept {
+    static_assert(sizeof...(Args) == PlaceholderCount(), "argument count does not match the format string");
+
+    char* cursor = out.Data();
+    char* const last = out.Data() + out.Size();
+    const bool written = [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+      return ((WriteLiteral<indices>(cursor, last) &&
+               detail::WriteArgument<pieces_[indices].spec>(args, cursor, last)) && ...);
+    }(std::index_sequence_for<Args...>{}) && WriteLiteral<PlaceholderCount()>(cursor, last);
+
+    if (!written) {
+      return std::nullopt;
+    }
+    return static_cast<std::size_t>(cursor - out.Data());
+  }
+};
+
+template <auto pattern, typename... Args>
+std::optional<std::size_t> FormatTo(Span<char> out, const Args&... args) noexcept {
+  return CompiledFormat<pattern>::FormatTo(out, args...);
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "../slice/Slice.hpp"
+#include "../span/Span.hpp"
+
+// MonotonicArena
+//
+// Bump allocator over a list of blocks. Memory is only reclaimed by Rewind
+// to a checkpoint or by Reset, both keep the blocks for reuse. Not thread
+// safe, one arena per request or per thread.
+class MonotonicArena : public std::pmr::memory_resource {
+ public:
+  struct Checkpoint {
+    std::size_t block;
+    std::size_t offset;
+  };
+
+  explicit MonotonicArena(std::size_t block_size = 64 * 1024,
+                          std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+    : block_size_{block_size}
+    , upstream_{upstream} {
+    assert(block_size_ > 0);
+    assert(upstream_ != nullptr);
+  }
+
+  MonotonicArena(const MonotonicArena&) = delete;
+  MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+  ~MonotonicArena() override {
+    for (const auto& block : blocks_) {
+      upstream_->deallocate(block.data, block.size, alignof(std::max_align_t));
+    }
+  }
+
+  void* Allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    if (current_ < blocks_.size()) {
+      if (void* result = BumpIn(blocks_[current_], bytes, alignment)) {
+        return result;
+      }
+    }
+    return AllocateSlow(bytes, alignment);
+  }
+
+  // Uninitialized storage for trivially destructible objects, default-initialized.
+  template <typename T>
+  Span<T> AllocateSpan(std::size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>, "the arena never runs destructors");
+    auto* data = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    std::uninitialized_default_construct_n(data, count);
+    return {data, count};
+  }
+
+  // Every stride-th element of a fresh count * stride buffer, the gaps are
+  // left for interleaved writers.
+  template <typename T>
+  Slice<T, dynamic_extent, dynamic_stride> AllocateSlice(std::size_t count, std::ptrdiff_t stride) {
+    assert(stride > 0);
+    auto span = AllocateSpan<T>(count * static_cast<std::size_t>(stride));
+    return {span.Data(), count, stride};
+  }
+
+  Checkpoint Mark() const noexcept {
+    return {current_, offset_};
+  }
+
+  void Rewind(Checkpoint checkpoint) noexcept {
+    assert(checkpoint.block < current_ || (checkpoint.block == current_ && checkpoint.offset <= offset_));
+    current_ = checkpoint.block;
+    offset_ = checkpoint.offset;
+  }
+
+  void Reset() noexcept {
+    current_ = 0;
+    offset_ = 0;
+  }
+
+  std::size_t Capacity() const noexcept {
+    std::size_t capacity = 0;
+    for (const auto& block : blocks_) {
+      capacity += block.size;
+    }
+    return capacity;
+  }
+
+ private:
+  struct Block {
+    std::byte* data;
+    std::size_t size;
+  };
+
+  void* BumpIn(const Block& block, std::size_t bytes, std::size_t alignment) noexcept {
+    const auto address = reinterpret_cast<std::uintptr_t>(block.data) + offset_;
+    const auto padding = (alignment - address % alignment) % alignment;
+    if (padding + bytes > block.size - offset_) {
+      return nullptr;
+    }
+    offset_ += padding + bytes;
+    return block.data + (offset_ - bytes);
+  }
+
+  void* AllocateSlow(std::size_t bytes, std::size_t alignment) {
+    // Move on to the next kept block, or splice in a fresh one that is large
+    // enough for this request.
+    const auto next = current_ < blocks_.size() ? current_ + 1 : 0;
+    const auto needed = bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+    if (next >= blocks_.size() || blocks_[next].size < needed) {
+      const auto size = std::max(block_size_, needed);
+      auto* data = static_cast<std::byte*>(upstream_->allocate(size, alignof(std::max_align_t)));
+      blocks_.insert(blocks_.begin() + static_cast<std::ptrdiff_t>(next), Block{data, size});
+    }
+    current_ = next;
+    offset_ = 0;
+
+    void* result = BumpIn(blocks_[current_], bytes, alignment);
+    assert(result != nullptr);
+    return result;
+  }
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    return Allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void*, std::size_t, std::size_t) override {
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::size_t block_size_;
+  std::pmr::memory_resource* upstream_;
+  std::vector<Block> blocks_;
+  std::size_t current_ = 0;
+  std::size_t offset_ = 0;
+};
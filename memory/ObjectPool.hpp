@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+// FixedBlockPool
+//
+// Fixed number of equally sized blocks carved from one slab. Free blocks
+// form a lock-free stack, so any thread may allocate or release. The head
+// carries a generation tag next to the block index against ABA.
+// As a memory_resource it serves fitting requests from the slab and passes
+// the rest, including requests made while the slab is exhausted, upstream.
+class FixedBlockPool : public std::pmr::memory_resource {
+ public:
+  FixedBlockPool(std::size_t block_size, std::size_t block_count,
+                 std::size_t alignment = alignof(std::max_align_t),
+                 std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+    : block_size_{(std::max(block_size, alignment) + alignment - 1) / alignment * alignment}
+    , block_count_{block_count}
+    , alignment_{alignment}
+    , upstream_{upstream}
+    , slab_{static_cast<std::byte*>(upstream_->allocate(block_size_ * block_count_, alignment_))}
+    , next_{std::make_unique<std::atomic<std::uint32_t>[]>(block_count_)} {
+    assert(block_count_ < std::numeric_limits<std::uint32_t>::max());
+    for (std::size_t i = 0; i < block_count_; ++i) {
+      next_[i].store(static_cast<std::uint32_t>(i + 1 < block_count_ ? i + 2 : 0), std::memory_order_relaxed);
+    }
+    head_.store(block_count_ ? 1 : 0, std::memory_order_relaxed);
+  }
+
+  FixedBlockPool(const FixedBlockPool&) = delete;
+  FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+  ~FixedBlockPool() override {
+    upstream_->deallocate(slab_, block_size_ * block_count_, alignment_);
+  }
+
+  // Returns nullptr when every block is in use.
+  void* TryAllocate() noexcept {
+    auto head = head_.load(std::memory_order_acquire);
+    while (true) {
+      const auto index = static_cast<std::uint32_t>(head);
+      if (index == 0) {
+        return nullptr;
+      }
+      const auto next = next_[index - 1].load(std::memory_order_relaxed);
+      if (head_.compare_exchange_weak(head, Tagged(head, next), std::memory_order_acquire, std::memory_order_acquire)) {
+        return slab_ + (index - 1) * block_size_;
+      }
+    }
+  }
+
+  void Release(void* block) noexcept {
+    assert(Owns(block));
+    const auto index = static_cast<std::uint32_t>((static_cast<std::byte*>(block) - slab_) / block_size_ + 1);
+    auto head = head_.load(std::memory_order_relaxed);
+    do {
+      next_[index - 1].store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(head, Tagged(head, index), std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  bool Owns(const void* pointer) const noexcept {
+    const auto* byte = static_cast<const std::byte*>(pointer);
+    return std::less_equal<>{}(slab_, byte) && std::less<>{}(byte, slab_ + block_size_ * block_count_);
+  }
+
+  std::size_t BlockSize() const noexcept {
+    return block_size_;
+  }
+
+  std::size_t BlockCount() const noexcept {
+    return block_count_;
+  }
+
+ private:
+  static std::uint64_t Tagged(std::uint64_t head, std::uint32_t index) noexcept {
+    return ((head >> 32) + 1) << 32 | index;
+  }
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    if (bytes <= block_size_ && alignment <= alignment_) {
+      if (void* block = TryAllocate()) {
+        return block;
+      }
+    }
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+    if (Owns(pointer)) {
+      Release(pointer);
+    } else {
+      upstream_->deallocate(pointer, bytes, alignment);
+    }
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::size_t block_size_;
+  std::size_t block_count_;
+  std::size_t alignment_;
+  std::pmr::memory_resource* upstream_;
+  std::byte* slab_;
+  // Successor of every free block, as 1-based indices with 0 ending the list.
+  std::unique_ptr<std::atomic<std::uint32_t>[]> next_;
+  // Generation tag in the high half, 1-based index of the top block in the low half.
+  alignas(64) std::atomic<std::uint64_t> head_;
+};
+
+
+// ObjectPool
+//
+// Typed front end of FixedBlockPool. New returns nullptr when the pool is
+// exhausted, Delete may be called from any thread.
+template <typename T>
+class ObjectPool {
+ public:
+  explicit ObjectPool(std::size_t capacity,
+                      std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+    : pool_{sizeof(T), capacity, alignof(T), upstream} {
+  }
+
+  template <typename... Args>
+  T* New(Args&&... args) {
+    void* block = pool_.TryAllocate();
+    if (block == nullptr) {
+      return nullptr;
+    }
+    try {
+      return new (block) T(std::forward<Args>(args)...);
+    } catch (...) {
+      pool_.Release(block);
+      throw;
+    }
+  }
+
+  void Delete(T* object) noexcept {
+    if (object != nullptr) {
+      std::destroy_at(object);
+      pool_.Release(object);
+    }
+  }
+
+  FixedBlockPool& Resource() noexcept {
+    return pool_;
+  }
+
+ private:
+  FixedBlockPool pool_;
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "../type_lists/type_lists.hpp"
+#include "../type_lists/value_types.hpp"
+#include "PolymorphicMapper.hpp"
+
+// Two mappings overlap if one object can match both of them. Reordering never
+// moves overlapping mappings past each other, so first-match-wins still holds.
+// Unrelated bases can still meet in a class deriving from both,
+//
+//   struct Both : IFoo, IBar {};  // matches Mapping<IFoo, 1> and Mapping<IBar, 2>
+//
+// so any two bases overlap unless one derives from neither and is final.
+// Specialize to std::false_type, in either order, for bases no class joins:
+//
+//   template <>
+//   struct MappingsOverlap<Circle, Square> : std::false_type {};
+template <typename Lhs, typename Rhs>
+struct MappingsOverlap
+  : std::bool_constant<std::is_base_of_v<Lhs, Rhs> || std::is_base_of_v<Rhs, Lhs> ||
+                       (!std::is_final_v<Lhs> && !std::is_final_v<Rhs>)> {};
+
+namespace detail {
+
+template <typename... Mappings>
+consteval auto OverlapTable() noexcept {
+  constexpr std::size_t count = sizeof...(Mappings);
+  std::array<std::array<bool, count>, count> table{};
+  std::size_t i = 0;
+  ([&]<typename Lhs>() {
+    std::size_t j = 0;
+    ((table[i][j++] = MappingsOverlap<typename Lhs::Base, typename Mappings::Base>::value &&
+                      MappingsOverlap<typename Mappings::Base, typename Lhs::Base>::value), ...);
+    ++i;
+  }.template operator()<Mappings>(), ...);
+  return table;
+}
+
+template <typename... Mappings>
+consteval bool IsValidOrder(const std::array<std::size_t, sizeof...(Mappings)>& order) noexcept {
+  constexpr auto overlaps = OverlapTable<Mappings...>();
+  std::array<bool, sizeof...(Mappings)> seen{};
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    if (order[i] >= order.size() || seen[order[i]]) {
+      return false;
+    }
+    seen[order[i]] = true;
+    for (std::size_t j = i + 1; j < order.size(); ++j) {
+      if (order[i] > order[j] && overlaps[order[i]][order[j]]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename Order, typename Base, typename Target, typename... Mappings>
+struct ReorderedMapperHelper;
+
+template <auto... indices, typename Base, typename Target, typename... Mappings>
+struct ReorderedMapperHelper<type_tuples::TTuple<value_types::ValueTag<indices>...>, Base, Target, Mappings...> {
+  static_assert(sizeof...(indices) == sizeof...(Mappings), "order must list every mapping once");
+  static_assert(IsValidOrder<Mappings...>({static_cast<std::size_t>(indices)...}),
+                "order must be a permutation that keeps overlapping mappings in declaration order");
+
+  using MappingList = type_lists::FromTuple<type_tuples::TTuple<Mappings...>>;
+
+  using Type = PolymorphicMapper<
+    Base, Target, typename type_lists::Drop<static_cast<std::size_t>(indices), MappingList>::Head...>;
+};
+
+} // namespace detail
+
+
+// ReorderedPolymorphicMapper
+//
+// PolymorphicMapper over Mappings permuted by Order, a value_types::VTuple
+// of indices such as the one printed by AdaptivePolymorphicMapper::WriteOrder.
+template <typename Order, typename Base, typename Target, typename... Mappings>
+using ReorderedPolymorphicMapper = typename detail::ReorderedMapperHelper<Order, Base, Target, Mappings...>::Type;
+
+
+// AdaptivePolymorphicMapper
+//
+// Walks the mappings in a runtime order and moves a mapping one step towards
+// the front whenever it has matched more often than its predecessor. Holds
+// plain counters, so use one instance per thread.
+template <typename Base, typename Target, typename... Mappings>
+requires (detail::IsMapping<Mappings, Target> && ...)
+class AdaptivePolymorphicMapper {
+ public:
+  static constexpr std::size_t MappingCount = sizeof...(Mappings);
+
+  AdaptivePolymorphicMapper() noexcept {
+    std::iota(order_.begin(), order_.end(), std::size_t{0});
+  }
+
+  std::optional<Target> map(const Base& base) noexcept {
+    for (std::size_t position = 0; position < MappingCount; ++position) {
+      const auto mapping = order_[position];
+      if (matchers_[mapping](base)) {
+        Promote(position);
+        return targets_[mapping];
+      }
+    }
+    return std::nullopt;
+  }
+
+  const std::array<std::size_t, MappingCount>& Order() const noexcept {
+    return order_;
+  }
+
+  const std::array<std::uint32_t, MappingCount>& Hits() const noexcept {
+    return hits_;
+  }
+
+  // Prints the learned order as a VTuple for ReorderedPolymorphicMapper.
+  void WriteOrder(std::ostream& out) const {
+    out << "value_types::VTuple<std::size_t";
+    for (const auto mapping : order_) {
+      out << ", " << mapping;
+    }
+    out << '>';
+  }
+
+ private:
+  using Matcher = bool (*)(const Base&) noexcept;
+
+  template <typename Mapping>
+  static bool Matches(const Base& base) noexcept {
+    return dynamic_cast<const typename Mapping::Base*>(std::addressof(base)) != nullptr;
+  }
+
+  void Promote(std::size_t position) noexcept {
+    const auto mapping = order_[position];
+    if (++hits_[mapping] == std::numeric_limits<std::uint32_t>::max()) {
+      // Age the counters so the order keeps following the workload.
+      for (auto& hits : hits_) {
+        hits /= 2;
+      }
+    }
+
+    if (position == 0) {
+      return;
+    }
+    const auto previous = order_[position - 1];
+    if (hits_[mapping] > hits_[previous] && !overlaps_[mapping][previous]) {
+      std::swap(order_[position - 1], order_[position]);
+    }
+  }
+
+  static constexpr std::array<Matcher, MappingCount> matchers_{&Matches<Mappings>...};
+  static constexpr std::array<Target, MappingCount> targets_{Mappings::Target()...};
+  static constexpr auto overlaps_ = detail::OverlapTable<Mappings...>();
+
+  std::array<std::size_t, MappingCount> order_;
+  std::array<std::uint32_t, MappingCount> hits_{};
+};
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+#include "../type_lists/type_lists.hpp"
+#include "PolymorphicMapper.hpp"
+
+// Hierarchies opt in by deriving their root from WithClassId<Root> and
+// specializing DirectSubclasses for every class that has subclasses:
+//
+//   struct Circle;
+//   struct Polygon;
+//   template <>
+//   struct DirectSubclasses<Shape> {
+//     using Type = type_lists::FromTuple<type_tuples::TTuple<Circle, Polygon>>;
+//   };
+//
+// Classes are numbered in depth-first pre-order, so the subclasses of T
+// occupy the id range [ClassIdOf<T>, ClassIdOf<T> + ClassCount<T>).
+// Every constructor passes ClassIdOf<Self> down to its base.
+template <typename T>
+struct DirectSubclasses {
+  using Type = type_lists::Nil;
+};
+
+template <typename Root>
+class WithClassId {
+ public:
+  using ClassIdRoot = Root;
+
+  constexpr std::uint32_t ClassId() const noexcept {
+    return class_id_;
+  }
+
+ protected:
+  constexpr explicit WithClassId(std::uint32_t class_id) noexcept
+    : class_id_{class_id} {
+  }
+
+ private:
+  std::uint32_t class_id_;
+};
+
+template <typename T>
+concept HasClassId = requires(const T& object) {
+  typename T::ClassIdRoot;
+  { object.ClassId() } -> std::convertible_to<std::uint32_t>;
+};
+
+namespace detail {
+
+inline constexpr std::size_t NoClassId = std::numeric_limits<std::size_t>::max();
+
+template <typename T>
+using Subclasses = type_lists::ToTuple<typename DirectSubclasses<T>::Type>;
+
+template <typename T>
+consteval std::size_t SubtreeSize() noexcept {
+  return []<typename... Children>(type_tuples::TTuple<Children...>) {
+    return (std::size_t{1} + ... + SubtreeSize<Children>());
+  }(Subclasses<T>{});
+}
+
+template <typename Root, typename T>
+consteval std::size_t PreorderIndex() noexcept {
+  if constexpr (std::is_same_v<Root, T>) {
+    return 0;
+  } else {
+    return []<typename... Children>(type_tuples::TTuple<Children...>) {
+      [[maybe_unused]] std::size_t offset = 1;
+      std::size_t result = NoClassId;
+      ([&] {
+        if (result == NoClassId) {
+          if (const auto index = PreorderIndex<Children, T>(); index != NoClassId) {
+            result = offset + index;
+          }
+          offset += SubtreeSize<Children>();
+        }
+      }(), ...);
+      return result;
+    }(Subclasses<Root>{});
+  }
+}
+
+template <typename Root, typename T>
+consteval std::uint32_t ClassIdIn() noexcept {
+  constexpr auto index = PreorderIndex<Root, T>();
+  static_assert(index != NoClassId, "class is not reachable from the hierarchy root through DirectSubclasses");
+  static_assert(index <= std::numeric_limits<std::uint32_t>::max());
+  return static_cast<std::uint32_t>(index);
+}
+
+} // namespace detail
+
+template <typename T>
+inline constexpr std::uint32_t ClassIdOf = detail::ClassIdIn<typename T::ClassIdRoot, T>();
+
+template <typename T>
+inline constexpr std::uint32_t ClassCount = static_cast<std::uint32_t>(detail::SubtreeSize<T>());
+
+// LLVM classof-style checks: one subtraction and one unsigned compare.
+template <typename T, HasClassId U>
+constexpr bool IsA(const U& object) noexcept {
+  return object.ClassId() - ClassIdOf<T> < ClassCount<T>;
+}
+
+template <typename T, HasClassId U>
+constexpr const T* DynCast(const U* object) noexcept {
+  return object != nullptr && IsA<T>(*object) ? static_cast<const T*>(object) : nullptr;
+}
+
+template <typename T, HasClassId U>
+constexpr T* DynCast(U* object) noexcept {
+  return object != nullptr && IsA<T>(*object) ? static_cast<T*>(object) : nullptr;
+}
+
+
+// ClassIdMapper
+//
+// PolymorphicMapper for hierarchies with class ids: the first matching
+// mapping for every class is resolved at compile time, so map() is a single
+// table lookup and needs no RTTI.
+template <HasClassId Base, typename Target, typename... Mappings>
+requires (detail::IsMapping<Mappings, Target> && ...)
+struct ClassIdMapper {
+  using Root = typename Base::ClassIdRoot;
+
+  static constexpr std::optional<Target> map(const Base& base) noexcept {
+    const std::size_t id = base.ClassId();
+    return id < table_.size() ? table_[id] : std::nullopt;
+  }
+
+ private:
+  static constexpr auto table_ = [] {
+    std::array<std::optional<Target>, detail::SubtreeSize<Root>()> table{};
+    ([&] {
+      constexpr std::size_t first = detail::ClassIdIn<Root, typename Mappings::Base>();
+      constexpr std::size_t count = detail::SubtreeSize<typename Mappings::Base>();
+      for (auto id = first; id < first + count; ++id) {
+        if (!table[id]) {
+          table[id] = Mappings::Target();
+        }
+      }
+    }(), ...);
+    return table;
+  }();
+};
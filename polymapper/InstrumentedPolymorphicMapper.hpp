@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <typeinfo>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "PolymorphicMapper.hpp"
+
+namespace detail {
+
+inline std::uint64_t ReadCycles() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+} // namespace detail
+
+
+// MapperStats
+//
+// Counters of one mapper. Entry i describes Mappings[i], the last entry
+// describes calls that matched nothing. Latency is a log2 histogram of the
+// sampled calls, in cycles.
+template <std::size_t mapping_count>
+struct MapperStats {
+  static constexpr std::size_t LatencyBuckets = 32;
+
+  struct Entry {
+    std::uint64_t hits = 0;
+    std::uint64_t depth_sum = 0;
+    std::array<std::uint64_t, LatencyBuckets> latency{};
+  };
+
+  MapperStats& operator+=(const MapperStats& other) noexcept {
+    calls += other.calls;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      entries[i].hits += other.entries[i].hits;
+      entries[i].depth_sum += other.entries[i].depth_sum;
+      for (std::size_t bucket = 0; bucket < LatencyBuckets; ++bucket) {
+        entries[i].latency[bucket] += other.entries[i].latency[bucket];
+      }
+    }
+    return *this;
+  }
+
+  constexpr const Entry& Misses() const noexcept {
+    return entries.back();
+  }
+
+  std::uint64_t calls = 0;
+  std::array<Entry, mapping_count + 1> entries{};
+};
+
+
+// NoInstrumentation
+//
+// Every hook is empty, the instrumented mapper compiles to the same code as
+// PolymorphicMapper.
+struct NoInstrumentation {
+  template <typename Mapper, std::size_t mapping_count>
+  struct Counters {
+    static constexpr bool Enabled = false;
+
+    struct Probe {};
+
+    static Probe Begin() noexcept {
+      return {};
+    }
+
+    static void End(Probe, std::size_t, std::size_t) noexcept {
+    }
+  };
+};
+
+
+// SampledInstrumentation
+//
+// Counts hits and dynamic_cast depth on every call and measures latency on
+// every sample_period-th call. Counters are plain per-thread integers; a
+// thread publishes them with Flush() or when it exits, Snapshot() returns
+// everything published plus the calling thread's counters. Reset() only
+// reaches the same two, so quiesce and flush the other threads first.
+template <std::size_t sample_period = 64>
+requires (sample_period > 0)
+struct SampledInstrumentation {
+  template <typename Mapper, std::size_t mapping_count>
+  struct Counters {
+    using Stats = MapperStats<mapping_count>;
+
+    static constexpr bool Enabled = true;
+
+    struct Probe {
+      std::uint64_t start;
+    };
+
+    static Probe Begin() noexcept {
+      auto& local = local_.stats;
+      return {local.calls++ % sample_period == 0 ? detail::ReadCycles() : 0};
+    }
+
+    static void End(Probe probe, std::size_t mapping, std::size_t depth) noexcept {
+      auto& entry = local_.stats.entries[mapping];
+      ++entry.hits;
+      entry.depth_sum += depth;
+      if (probe.start != 0) {
+        const auto cycles = detail::ReadCycles() - probe.start;
+        ++entry.latency[std::min<std::size_t>(std::bit_width(cycles), Stats::LatencyBuckets - 1)];
+      }
+    }
+
+    static Stats ThreadSnapshot() noexcept {
+      return local_.stats;
+    }
+
+    static Stats Snapshot() {
+      std::lock_guard lock{mutex_};
+      Stats stats = retired_;
+      stats += local_.stats;
+      return stats;
+    }
+
+    static void Flush() {
+      std::lock_guard lock{mutex_};
+      retired_ += local_.stats;
+      local_.stats = {};
+    }
+
+    // Clears the published counters and the calling thread's own. Counters
+    // other live threads have not flushed yet are kept.
+    static void Reset() {
+      std::lock_guard lock{mutex_};
+      retired_ = {};
+      local_.stats = {};
+    }
+
+   private:
+    struct Local {
+      ~Local() {
+        std::lock_guard lock{mutex_};
+        retired_ += stats;
+      }
+
+      Stats stats;
+    };
+
+    static inline std::mutex mutex_;
+    static inline Stats retired_;
+    static inline thread_local Local local_;
+  };
+};
+
+
+template <std::size_t mapping_count>
+void WriteMapperStatsText(std::ostream& out, const MapperStats<mapping_count>& stats,
+                          const std::array<const char*, mapping_count>& names) {
+  const auto write_entry = [&](const char* name, const auto& entry) {
+    out << "  " << name << ": hits=" << entry.hits << " mean_depth="
+        << (entry.hits ? static_cast<double>(entry.depth_sum) / entry.hits : 0.0) << " latency_log2_cycles=[";
+    for (std::size_t bucket = 0; bucket < entry.latency.size(); ++bucket) {
+      out << (bucket ? "," : "") << entry.latency[bucket];
+    }
+    out << "]\n";
+  };
+
+  out << "calls=" << stats.calls << '\n';
+  for (std::size_t i = 0; i < mapping_count; ++i) {
+    write_entry(names[i], stats.entries[i]);
+  }
+  write_entry("<miss>", stats.Misses());
+}
+
+template <std::size_t mapping_count>
+void WriteMapperStatsJson(std::ostream& out, const MapperStats<mapping_count>& stats,
+                          const std::array<const char*, mapping_count>& names) {
+  const auto write_entry = [&](const auto& entry) {
+    out << "\"hits\":" << entry.hits << ",\"depth_sum\":" << entry.depth_sum << ",\"latency_log2_cycles\":[";
+    for (std::size_t bucket = 0; bucket < entry.latency.size(); ++bucket) {
+      out << (bucket ? "," : "") << entry.latency[bucket];
+    }
+    out << ']';
+  };
+
+  out << "{\"calls\":" << stats.calls << ",\"mappings\":[";
+  for (std::size_t i = 0; i < mapping_count; ++i) {
+    // Mangled type names never contain quotes or backslashes.
+    out << (i ? "," : "") << "{\"index\":" << i << ",\"base\":\"" << names[i] << "\",";
+    write_entry(stats.entries[i]);
+    out << '}';
+  }
+  out << "],\"misses\":{";
+  write_entry(stats.Misses());
+  out << "}}";
+}
+
+
+// InstrumentedPolymorphicMapper
+//
+// Same first-match-wins dynamic_cast chain as PolymorphicMapper, reporting
+// every call to Policy::Counters.
+template <typename Policy, typename Base, typename Target, typename... Mappings>
+requires (detail::IsMapping<Mappings, Target> && ...)
+struct InstrumentedPolymorphicMapper {
+  using Counters = typename Policy::template Counters<InstrumentedPolymorphicMapper, sizeof...(Mappings)>;
+
+  static std::optional<Target> map(const Base& base) {
+    const auto probe = Counters::Begin();
+
+    std::size_t index = 0;
+    std::optional<Target> result;
+    ((dynamic_cast<const typename Mappings::Base*>(std::addressof(base))
+        ? (result = Mappings::Target(), true)
+        : (++index, false)) || ...);
+
+    Counters::End(probe, index, std::min(index + 1, sizeof...(Mappings)));
+    return result;
+  }
+
+  static std::array<const char*, sizeof...(Mappings)> MappingNames() noexcept {
+    return {typeid(typename Mappings::Base).name()...};
+  }
+
+  static void WriteText(std::ostream& out) requires Counters::Enabled {
+    WriteMapperStatsText(out, Counters::Snapshot(), MappingNames());
+  }
+
+  static void WriteJson(std::ostream& out) requires Counters::Enabled {
+    WriteMapperStatsJson(out, Counters::Snapshot(), MappingNames());
+  }
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "FixedString.hpp"
+
+template <typename Pool>
+class InternedString {
+ public:
+  constexpr explicit InternedString(std::uint32_t id) noexcept
+    : id_{id} {
+  }
+
+  constexpr std::uint32_t Id() const noexcept {
+    return id_;
+  }
+
+  constexpr std::string_view View() const noexcept {
+    return Pool::View(id_);
+  }
+
+  constexpr operator std::string_view() const noexcept {
+    return View();
+  }
+
+  constexpr bool operator==(const InternedString&) const noexcept = default;
+
+ private:
+  std::uint32_t id_;
+};
+
+
+// StringPool
+//
+// Interns a set of strings known at compile time, usually FixedString NTTPs:
+//
+//   using Labels = StringPool<"host"_cstr, "region"_cstr, "shard"_cstr>;
+//   switch (label.Id()) {
+//     case Labels::Id<"host"_cstr>: ...
+//   }
+//
+// Equal strings share one dense id, and every distinct string is stored
+// once in a single constant blob.
+template <auto... strings>
+requires (std::convertible_to<decltype(strings), std::string_view> && ...)
+class StringPool {
+ private:
+  static constexpr std::array<std::string_view, sizeof...(strings)> inputs_{std::string_view{strings}...};
+
+  static constexpr auto input_ids_ = [] {
+    std::array<std::uint32_t, inputs_.size()> ids{};
+    std::uint32_t next = 0;
+    for (std::size_t i = 0; i < inputs_.size(); ++i) {
+      const auto first = std::find(inputs_.begin(), inputs_.begin() + i, inputs_[i]);
+      ids[i] = first == inputs_.begin() + i ? next++ : ids[first - inputs_.begin()];
+    }
+    return ids;
+  }();
+
+  static constexpr std::size_t unique_count_ = [] {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < inputs_.size(); ++i) {
+      count += input_ids_[i] == count;
+    }
+    return count;
+  }();
+
+  static constexpr auto offsets_ = [] {
+    std::array<std::size_t, unique_count_ + 1> offsets{};
+    for (std::size_t i = 0, id = 0; i < inputs_.size(); ++i) {
+      if (input_ids_[i] == id) {
+        offsets[id + 1] = offsets[id] + inputs_[i].size();
+        ++id;
+      }
+    }
+    return offsets;
+  }();
+
+  static constexpr auto blob_ = [] {
+    std::array<char, offsets_.back()> blob{};
+    for (std::size_t i = 0, id = 0; i < inputs_.size(); ++i) {
+      if (input_ids_[i] == id) {
+        std::copy(inputs_[i].begin(), inputs_[i].end(), blob.begin() + offsets_[id++]);
+      }
+    }
+    return blob;
+  }();
+
+  // Ids ordered by their strings, for lookups of runtime strings.
+  static constexpr auto sorted_ = [] {
+    std::array<std::uint32_t, unique_count_> sorted{};
+    for (std::uint32_t id = 0; id < unique_count_; ++id) {
+      sorted[id] = id;
+    }
+    const auto view = [](std::uint32_t id) {
+      return std::string_view{blob_.data() + offsets_[id], offsets_[id + 1] - offsets_[id]};
+    };
+    std::sort(sorted.begin(), sorted.end(), [&](auto lhs, auto rhs) { return view(lhs) < view(rhs); });
+    return sorted;
+  }();
+
+  template <auto string>
+  static consteval std::uint32_t IdOf() {
+    const auto input = std::find(inputs_.begin(), inputs_.end(), std::string_view{string});
+    if (input == inputs_.end()) {
+      throw "string is not part of the pool";
+    }
+    return input_ids_[input - inputs_.begin()];
+  }
+
+ public:
+  using interned_type = InternedString<StringPool>;
+
+  template <auto string>
+  static constexpr std::uint32_t Id = IdOf<string>();
+
+  template <auto string>
+  static constexpr interned_type Intern{Id<string>};
+
+  static constexpr std::size_t Size() noexcept {
+    return unique_count_;
+  }
+
+  static constexpr std::size_t SizeBytes() noexcept {
+    return blob_.size();
+  }
+
+  static constexpr std::string_view View(std::uint32_t id) noexcept {
+    assert(id < unique_count_);
+    return {blob_.data() + offsets_[id], offsets_[id + 1] - offsets_[id]};
+  }
+
+  static constexpr std::optional<interned_type> Find(std::string_view string) noexcept {
+    const auto it = std::lower_bound(sorted_.begin(), sorted_.end(), string,
+                                     [](auto id, std::string_view value) { return View(id) < value; });
+    if (it == sorted_.end() || View(*it) != string) {
+      return std::nullopt;
+    }
+    return interned_type{*it};
+  }
+};
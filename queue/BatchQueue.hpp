@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "../span/Span.hpp"
+
+namespace detail {
+
+inline constexpr std::size_t CacheLineSize = 64;
+
+// Index owned by one side of a queue together with the other side's index as
+// last seen, so the shared line is only read when the cached value runs out.
+struct alignas(CacheLineSize) QueueCursor {
+  std::atomic<std::uint64_t> position{0};
+  std::uint64_t cached_other = 0;
+};
+
+// Next position one side of a multi-threaded queue hands out, alone on its
+// cache line.
+struct alignas(CacheLineSize) QueueHead {
+  std::atomic<std::uint64_t> position{0};
+};
+
+} // namespace detail
+
+
+// Contiguous run of queue slots. Empty when the queue had nothing to offer,
+// shorter than asked for when the run reaches the end of the ring or, in an
+// MpmcQueue, a slot another thread has not committed yet.
+template <typename T>
+struct QueueReservation {
+  Span<T> slots;
+  std::uint64_t position = 0;
+
+  std::size_t Size() const noexcept {
+    return slots.Size();
+  }
+
+  bool Empty() const noexcept {
+    return slots.Size() == 0;
+  }
+};
+
+
+// SpscQueue
+//
+// Bounded ring for one producer and one consumer. Producers fill reserved
+// slots in place and publish them with one store per batch, consumers read
+// ready slots in place and hand them back the same way.
+template <typename T, std::size_t capacity>
+requires (std::has_single_bit(capacity)) && std::is_default_constructible_v<T>
+class SpscQueue {
+ public:
+  using WriteReservation = QueueReservation<T>;
+  using ReadReservation  = QueueReservation<const T>;
+
+  SpscQueue()
+    : slots_{std::make_unique<T[]>(capacity)} {
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  static constexpr std::size_t Capacity() noexcept {
+    return capacity;
+  }
+
+  WriteReservation ReserveWrite(std::size_t count) noexcept {
+    const auto tail = producer_.position.load(std::memory_order_relaxed);
+    if (tail - producer_.cached_other + count > capacity) {
+      producer_.cached_other = consumer_.position.load(std::memory_order_acquire);
+    }
+    const auto free = capacity - (tail - producer_.cached_other);
+    return {Run(tail, std::min(count, free)), tail};
+  }
+
+  void CommitWrite(const WriteReservation& reservation) noexcept {
+    producer_.position.store(reservation.position + reservation.Size(), std::memory_order_release);
+  }
+
+  ReadReservation ReserveRead(std::size_t count) noexcept {
+    const auto head = consumer_.position.load(std::memory_order_relaxed);
+    if (consumer_.cached_other - head < count) {
+      consumer_.cached_other = producer_.position.load(std::memory_order_acquire);
+    }
+    const auto ready = consumer_.cached_other - head;
+    return {Run(head, std::min(count, ready)), head};
+  }
+
+  void CommitRead(const ReadReservation& reservation) noexcept {
+    consumer_.position.store(reservation.position + reservation.Size(), std::memory_order_release);
+  }
+
+  template <typename U>
+  bool TryPush(U&& value) {
+    const auto reservation = ReserveWrite(1);
+    if (reservation.Empty()) {
+      return false;
+    }
+    reservation.slots[0] = std::forward<U>(value);
+    CommitWrite(reservation);
+    return true;
+  }
+
+  std::optional<T> TryPop() {
+    const auto reservation = ReserveRead(1);
+    if (reservation.Empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> value{reservation.slots[0]};
+    CommitRead(reservation);
+    return value;
+  }
+
+ private:
+  Span<T> Run(std::uint64_t position, std::size_t count) const noexcept {
+    const auto offset = static_cast<std::size_t>(position & (capacity - 1));
+    return {slots_.get() + offset, std::min(count, capacity - offset)};
+  }
+
+  std::unique_ptr<T[]> slots_;
+  detail::QueueCursor producer_;
+  detail::QueueCursor consumer_;
+};
+
+
+// MpmcQueue
+//
+// Bounded ring for any number of producers and consumers. Every slot carries
+// a sequence number telling which lap it is at and whether it is free or
+// filled. A reservation claims the longest run of slots ready for its side
+// with one CAS on that side's head, and the commit hands each slot over by
+// bumping its sequence number. No thread ever waits on another: a thread
+// stalled between reservation and commit only keeps its own slots from the
+// other side, reservations behind them come back short or empty.
+template <typename T, std::size_t capacity>
+requires (std::has_single_bit(capacity)) && std::is_default_constructible_v<T>
+class MpmcQueue {
+ public:
+  using WriteReservation = QueueReservation<T>;
+  using ReadReservation  = QueueReservation<const T>;
+
+  MpmcQueue()
+    : slots_{std::make_unique<T[]>(capacity)}
+    , sequences_{std::make_unique<std::atomic<std::uint64_t>[]>(capacity)} {
+    for (std::size_t i = 0; i < capacity; ++i) {
+      sequences_[i].store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcQueue(const MpmcQueue&) = delete;
+  MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+  static constexpr std::size_t Capacity() noexcept {
+    return capacity;
+  }
+
+  // A free slot at position p has sequence number p, a filled one p + 1.
+  WriteReservation ReserveWrite(std::size_t count) noexcept {
+    const auto [position, claimed] = Claim(producers_, count, 0);
+    return {Run(position, claimed), position};
+  }
+
+  void CommitWrite(const WriteReservation& reservation) noexcept {
+    Publish(reservation.position, reservation.Size(), 1);
+  }
+
+  ReadReservation ReserveRead(std::size_t count) noexcept {
+    const auto [position, claimed] = Claim(consumers_, count, 1);
+    return {Run(position, claimed), position};
+  }
+
+  // Frees the slots for the producers' next lap.
+  void CommitRead(const ReadReservation& reservation) noexcept {
+    Publish(reservation.position, reservation.Size(), capacity);
+  }
+
+  template <typename U>
+  bool TryPush(U&& value) {
+    const auto reservation = ReserveWrite(1);
+    if (reservation.Empty()) {
+      return false;
+    }
+    reservation.slots[0] = std::forward<U>(value);
+    CommitWrite(reservation);
+    return true;
+  }
+
+  std::optional<T> TryPop() {
+    const auto reservation = ReserveRead(1);
+    if (reservation.Empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> value{reservation.slots[0]};
+    CommitRead(reservation);
+    return value;
+  }
+
+ private:
+  static std::size_t RunLength(std::uint64_t position, std::uint64_t count) noexcept {
+    const auto offset = static_cast<std::size_t>(position & (capacity - 1));
+    return static_cast<std::size_t>(std::min<std::uint64_t>(count, capacity - offset));
+  }
+
+  Span<T> Run(std::uint64_t position, std::size_t count) const noexcept {
+    return {slots_.get() + (position & (capacity - 1)), count};
+  }
+
+  std::uint64_t Sequence(std::uint64_t position) const noexcept {
+    return sequences_[position & (capacity - 1)].load(std::memory_order_acquire);
+  }
+
+  // Claims up to count slots from head whose sequence number is their
+  // position plus lag. Returns the first position and the number claimed.
+  std::pair<std::uint64_t, std::size_t> Claim(detail::QueueHead& head, std::size_t count, std::uint64_t lag) noexcept {
+    auto position = head.position.load(std::memory_order_relaxed);
+    while (count != 0) {
+      const auto sequence = Sequence(position);
+      if (sequence != position + lag) {
+        if (static_cast<std::int64_t>(sequence - (position + lag)) < 0) {
+          // Still owned by the other side: the ring is full or empty here.
+          return {position, 0};
+        }
+        // Another thread of this side claimed the slot, catch up.
+        position = head.position.load(std::memory_order_relaxed);
+        continue;
+      }
+      const auto limit = RunLength(position, count);
+      std::size_t ready = 1;
+      while (ready < limit && Sequence(position + ready) == position + ready + lag) {
+        ++ready;
+      }
+      if (head.position.compare_exchange_weak(position, position + ready, std::memory_order_relaxed)) {
+        return {position, ready};
+      }
+    }
+    return {position, 0};
+  }
+
+  void Publish(std::uint64_t position, std::size_t count, std::uint64_t advance) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+      sequences_[(position + i) & (capacity - 1)].store(position + i + advance, std::memory_order_release);
+    }
+  }
+
+  std::unique_ptr<T[]> slots_;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> sequences_;
+  detail::QueueHead producers_;
+  detail::QueueHead consumers_;
+};
@@ -0,0 +1,729 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../polymapper/FixedString.hpp"
+#include "../span/Span.hpp"
+
+namespace detail {
+
+using ByteSet = std::array<std::uint64_t, 4>;
+
+constexpr bool ByteSetHas(const ByteSet& set, unsigned char byte) noexcept {
+  return (set[byte / 64] >> (byte % 64)) & 1;
+}
+
+constexpr void ByteSetAdd(ByteSet& set, unsigned char first, unsigned char last) noexcept {
+  for (unsigned byte = first; byte <= last; ++byte) {
+    set[byte / 64] |= std::uint64_t{1} << (byte % 64);
+  }
+}
+
+constexpr void ByteSetInvert(ByteSet& set) noexcept {
+  for (auto& word : set) {
+    word = ~word;
+  }
+}
+
+inline constexpr std::size_t NoRegexNode = static_cast<std::size_t>(-1);
+
+// Thompson NFA node. A consuming node moves on a byte of `bytes` to out[0],
+// any other node moves to both outs without input.
+struct RegexNode {
+  ByteSet bytes{};
+  bool consumes = false;
+  std::array<std::size_t, 2> out{NoRegexNode, NoRegexNode};
+};
+
+template <std::size_t capacity>
+struct RegexNfa {
+  std::array<RegexNode, capacity> nodes{};
+  std::size_t size = 0;
+  std::size_t start = 0;
+  std::size_t accept = 0;
+  bool anchored_start = false;
+  bool anchored_end = false;
+};
+
+// Every fragment ends in a fresh non-consuming node with no outs yet.
+struct RegexFragment {
+  std::size_t start;
+  std::size_t end;
+};
+
+// Grammar: literals, ".", "[...]" and "[^...]" classes with ranges, the
+// escapes \d \D \w \W \s \S \n \r \t \f \v and escaped punctuation, groups
+// "(...)" and "(?:...)", "|", "*", "+" and "?". "^" and "$" anchor the whole
+// pattern and are only accepted at its ends; with a top-level "|" the
+// branches must be grouped, "^(a|b)$", since ECMAScript would anchor only
+// the first or last branch. "." does not match '\n'.
+template <std::size_t capacity>
+class RegexParser {
+ public:
+  consteval explicit RegexParser(std::string_view pattern)
+    : pattern_{pattern}
+    , end_{pattern.size()} {
+  }
+
+  consteval RegexNfa<capacity> Parse() {
+    if (position_ < end_ && pattern_[position_] == '^') {
+      nfa_.anchored_start = true;
+      ++position_;
+    }
+    if (end_ > position_ && pattern_[end_ - 1] == '$' && !Escaped(end_ - 1)) {
+      nfa_.anchored_end = true;
+      --end_;
+    }
+    const auto fragment = Alternation();
+    if (position_ != end_) {
+      throw "unmatched ')' in regex";
+    }
+    nfa_.start = fragment.start;
+    nfa_.accept = fragment.end;
+    return nfa_;
+  }
+
+ private:
+  consteval bool Escaped(std::size_t index) const {
+    std::size_t backslashes = 0;
+    while (index > backslashes && pattern_[index - backslashes - 1] == '\\') {
+      ++backslashes;
+    }
+    return backslashes % 2 == 1;
+  }
+
+  consteval std::size_t AddNode(const RegexNode& node) {
+    if (nfa_.size == capacity) {
+      throw "regex needs too many NFA nodes";
+    }
+    nfa_.nodes[nfa_.size] = node;
+    return nfa_.size++;
+  }
+
+  consteval void Link(std::size_t from, std::size_t to) {
+    auto& out = nfa_.nodes[from].out;
+    (out[0] == NoRegexNode ? out[0] : out[1]) = to;
+  }
+
+  consteval RegexFragment Bytes(const ByteSet& bytes) {
+    const auto start = AddNode({bytes, true});
+    const auto end = AddNode({});
+    Link(start, end);
+    return {start, end};
+  }
+
+  consteval RegexFragment Alternation() {
+    auto result = Concatenation();
+    while (position_ < end_ && pattern_[position_] == '|') {
+      if (group_depth_ == 0 && (nfa_.anchored_start || nfa_.anchored_end)) {
+        throw "anchored regex with a top-level '|' needs a group, as in ^(a|b)$";
+      }
+      ++position_;
+      const auto other = Concatenation();
+      const auto start = AddNode({});
+      const auto end = AddNode({});
+      Link(start, result.start);
+      Link(start, other.start);
+      Link(result.end, end);
+      Link(other.end, end);
+      result = {start, end};
+    }
+    return result;
+  }
+
+  consteval RegexFragment Concatenation() {
+    const auto empty = AddNode({});
+    RegexFragment result{empty, empty};
+    while (position_ < end_ && pattern_[position_] != '|' && pattern_[position_] != ')') {
+      const auto next = Repetition();
+      Link(result.end, next.start);
+      result.end = next.end;
+    }
+    return result;
+  }
+
+  consteval RegexFragment Repetition() {
+    auto atom = Atom();
+    while (position_ < end_) {
+      const char c = pattern_[position_];
+      if (c == '{') {
+        throw "counted repetition is not supported";
+      }
+      if (c != '*' && c != '+' && c != '?') {
+        break;
+      }
+      ++position_;
+      const auto end = AddNode({});
+      if (c == '+') {
+        Link(atom.end, atom.start);
+        Link(atom.end, end);
+        atom.end = end;
+        continue;
+      }
+      const auto start = AddNode({});
+      Link(start, atom.start);
+      Link(start, end);
+      if (c == '*') {
+        Link(atom.end, atom.start);
+      }
+      Link(atom.end, end);
+      atom = {start, end};
+    }
+    return atom;
+  }
+
+  consteval RegexFragment Atom() {
+    const char c = pattern_[position_++];
+    switch (c) {
+      case '(': {
+        if (end_ - position_ >= 2 && pattern_[position_] == '?' && pattern_[position_ + 1] == ':') {
+          position_ += 2;
+        }
+        ++group_depth_;
+        const auto group = Alternation();
+        if (position_ == end_ || pattern_[position_] != ')') {
+          throw "unmatched '(' in regex";
+        }
+        --group_depth_;
+        ++position_;
+        return group;
+      }
+      case '[':
+        return Bytes(Class());
+      case '.': {
+        ByteSet bytes{};
+        ByteSetAdd(bytes, 0, 255);
+        bytes['\n' / 64] &= ~(std::uint64_t{1} << ('\n' % 64));
+        return Bytes(bytes);
+      }
+      case '\\':
+        return Bytes(Escape());
+      case '*':
+      case '+':
+      case '?':
+        throw "quantifier without operand in regex";
+      case '^':
+      case '$':
+        throw "anchors are only supported at the ends of a regex";
+      default: {
+        ByteSet bytes{};
+        ByteSetAdd(bytes, static_cast<unsigned char>(c), static_cast<unsigned char>(c));
+        return Bytes(bytes);
+      }
+    }
+  }
+
+  // Parses the character after a backslash, inside or outside a class.
+  consteval ByteSet Escape() {
+    if (position_ == end_) {
+      throw "trailing backslash in regex";
+    }
+    const char c = pattern_[position_++];
+    ByteSet bytes{};
+    const auto single = [&bytes](char byte) {
+      ByteSetAdd(bytes, static_cast<unsigned char>(byte), static_cast<unsigned char>(byte));
+    };
+    switch (c) {
+      case 'd':
+      case 'D':
+        ByteSetAdd(bytes, '0', '9');
+        break;
+      case 'w':
+      case 'W':
+        ByteSetAdd(bytes, '0', '9');
+        ByteSetAdd(bytes, 'A', 'Z');
+        ByteSetAdd(bytes, 'a', 'z');
+        single('_');
+        break;
+      case 's':
+      case 'S':
+        ByteSetAdd(bytes, '\t', '\r');
+        single(' ');
+        break;
+      case 'n':
+        single('\n');
+        break;
+      case 'r':
+        single('\r');
+        break;
+      case 't':
+        single('\t');
+        break;
+      case 'f':
+        single('\f');
+        break;
+      case 'v':
+        single('\v');
+        break;
+      default:
+        if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+          throw "unsupported escape in regex";
+        }
+        single(c);
+    }
+    if (c == 'D' || c == 'W' || c == 'S') {
+      ByteSetInvert(bytes);
+    }
+    return bytes;
+  }
+
+  // Parses a class after its '['. As in ECMAScript "[]" matches nothing and
+  // "[^]" any byte.
+  consteval ByteSet Class() {
+    ByteSet bytes{};
+    const bool negated = position_ < end_ && pattern_[position_] == '^';
+    position_ += negated;
+    while (true) {
+      if (position_ >= end_) {
+        throw "unterminated character class in regex";
+      }
+      if (pattern_[position_] == ']') {
+        break;
+      }
+      if (pattern_[position_] == '\\') {
+        ++position_;
+        const auto escaped = Escape();
+        for (std::size_t word = 0; word < bytes.size(); ++word) {
+          bytes[word] |= escaped[word];
+        }
+        continue;
+      }
+      const auto low = static_cast<unsigned char>(pattern_[position_++]);
+      auto high = low;
+      if (end_ - position_ >= 2 && pattern_[position_] == '-' && pattern_[position_ + 1] != ']') {
+        high = static_cast<unsigned char>(pattern_[position_ + 1]);
+        position_ += 2;
+        if (high < low) {
+          throw "reversed range in regex character class";
+        }
+      }
+      ByteSetAdd(bytes, low, high);
+    }
+    ++position_;
+    if (negated) {
+      ByteSetInvert(bytes);
+    }
+    return bytes;
+  }
+
+  std::string_view pattern_;
+  std::size_t position_ = 0;
+  std::size_t end_;
+  std::size_t group_depth_ = 0;
+  RegexNfa<capacity> nfa_;
+};
+
+// Bytes no consuming node tells apart share a class, so DFA rows have one
+// column per class instead of 256.
+struct RegexByteClasses {
+  std::array<std::uint8_t, 256> of{};
+  std::array<unsigned char, 256> representative{};
+  std::array<std::size_t, 256> sizes{};
+  std::size_t count = 1;
+};
+
+template <std::size_t capacity>
+consteval RegexByteClasses ByteClassesOf(const RegexNfa<capacity>& nfa) {
+  RegexByteClasses classes;
+  for (std::size_t node = 0; node < nfa.size; ++node) {
+    if (!nfa.nodes[node].consumes) {
+      continue;
+    }
+    std::array<int, 512> split{};
+    std::fill(split.begin(), split.end(), -1);
+    int count = 0;
+    for (unsigned byte = 0; byte < 256; ++byte) {
+      auto& id = split[classes.of[byte] * 2 + ByteSetHas(nfa.nodes[node].bytes, static_cast<unsigned char>(byte))];
+      if (id < 0) {
+        id = count++;
+      }
+      classes.of[byte] = static_cast<std::uint8_t>(id);
+    }
+    classes.count = static_cast<std::size_t>(count);
+  }
+  classes.sizes = {};
+  for (unsigned byte = 256; byte-- > 0;) {
+    classes.representative[classes.of[byte]] = static_cast<unsigned char>(byte);
+    ++classes.sizes[classes.of[byte]];
+  }
+  return classes;
+}
+
+template <std::size_t capacity>
+using RegexNodeSet = std::array<std::uint64_t, (capacity + 63) / 64>;
+
+template <std::size_t capacity>
+consteval bool NodeSetHas(const RegexNodeSet<capacity>& set, std::size_t node) {
+  return (set[node / 64] >> (node % 64)) & 1;
+}
+
+template <std::size_t capacity>
+consteval void NodeSetAdd(RegexNodeSet<capacity>& set, std::size_t node) {
+  set[node / 64] |= std::uint64_t{1} << (node % 64);
+}
+
+// For every node the consuming nodes and accept node reachable from it
+// without input. Subsets hold only those, so subsets that differ in
+// pass-through nodes alone become one state.
+template <std::size_t capacity>
+consteval std::array<RegexNodeSet<capacity>, capacity> RegexClosures(const RegexNfa<capacity>& nfa) {
+  std::array<RegexNodeSet<capacity>, capacity> closures{};
+  for (std::size_t from = 0; from < nfa.size; ++from) {
+    RegexNodeSet<capacity> seen{};
+    std::array<std::size_t, capacity> stack{};
+    std::size_t depth = 0;
+    NodeSetAdd<capacity>(seen, from);
+    stack[depth++] = from;
+    while (depth > 0) {
+      const auto node = stack[--depth];
+      if (nfa.nodes[node].consumes || node == nfa.accept) {
+        NodeSetAdd<capacity>(closures[from], node);
+      }
+      if (nfa.nodes[node].consumes) {
+        continue;
+      }
+      for (const auto next : nfa.nodes[node].out) {
+        if (next != NoRegexNode && !NodeSetHas<capacity>(seen, next)) {
+          NodeSetAdd<capacity>(seen, next);
+          stack[depth++] = next;
+        }
+      }
+    }
+  }
+  return closures;
+}
+
+inline constexpr std::size_t MaxRegexStates = 1024;
+
+template <std::size_t capacity>
+struct RegexSubsets {
+  std::array<RegexNodeSet<capacity>, MaxRegexStates> sets{};
+  std::array<bool, MaxRegexStates> accepting{};
+  std::size_t count = 0;
+};
+
+// Subset construction over byte classes. State 0 is the empty, dead set and
+// state 1 the start. A search automaton adds the start set after every byte,
+// so it tracks matches starting anywhere, and unless the pattern is anchored
+// at the end it stays accepting once it accepts. Calls on_edge(state, class,
+// target) for every transition.
+template <std::size_t capacity, typename OnEdge>
+consteval RegexSubsets<capacity> ExploreRegex(const RegexNfa<capacity>& nfa, const RegexByteClasses& classes, bool search,
+                                              OnEdge on_edge) {
+  constexpr std::size_t words = RegexNodeSet<capacity>{}.size();
+  const auto closures = RegexClosures(nfa);
+  const auto hash = [](const RegexNodeSet<capacity>& set) {
+    std::uint64_t value = 0;
+    for (const auto word : set) {
+      value = (value ^ word) * 0x9E3779B97F4A7C15ull;
+    }
+    return static_cast<std::size_t>(value >> 53);
+  };
+  // Open addressing over 2048 slots, each holding state + 1.
+  std::array<std::size_t, 2 * MaxRegexStates> slots{};
+  const auto find_or_add = [&](RegexSubsets<capacity>& subsets, const RegexNodeSet<capacity>& set) {
+    for (std::size_t slot = hash(set);; slot = (slot + 1) % slots.size()) {
+      if (slots[slot] == 0) {
+        if (subsets.count == MaxRegexStates) {
+          throw "regex needs too many DFA states";
+        }
+        subsets.sets[subsets.count] = set;
+        slots[slot] = ++subsets.count;
+        return subsets.count - 1;
+      }
+      if (subsets.sets[slots[slot] - 1] == set) {
+        return slots[slot] - 1;
+      }
+    }
+  };
+
+  RegexSubsets<capacity> subsets;
+  find_or_add(subsets, {});
+  const auto restart = closures[nfa.start];
+  find_or_add(subsets, restart);
+
+  for (std::size_t state = 1; state < subsets.count; ++state) {
+    const auto current = subsets.sets[state];
+    subsets.accepting[state] = NodeSetHas<capacity>(current, nfa.accept);
+    const bool absorbing = search && subsets.accepting[state] && !nfa.anchored_end;
+
+    std::array<RegexNodeSet<capacity>, 256> moves{};
+    for (std::size_t word = 0; word < words && !absorbing; ++word) {
+      for (auto bits = current[word]; bits != 0; bits &= bits - 1) {
+        const auto& node = nfa.nodes[word * 64 + static_cast<std::size_t>(std::countr_zero(bits))];
+        if (!node.consumes) {
+          continue;
+        }
+        for (std::size_t byte_class = 0; byte_class < classes.count; ++byte_class) {
+          if (ByteSetHas(node.bytes, classes.representative[byte_class])) {
+            for (std::size_t target_word = 0; target_word < words; ++target_word) {
+              moves[byte_class][target_word] |= closures[node.out[0]][target_word];
+            }
+          }
+        }
+      }
+    }
+
+    for (std::size_t byte_class = 0; byte_class < classes.count; ++byte_class) {
+      auto next = absorbing ? current : moves[byte_class];
+      if (search) {
+        for (std::size_t word = 0; word < words; ++word) {
+          next[word] |= restart[word];
+        }
+      }
+      on_edge(state, byte_class, find_or_add(subsets, next));
+    }
+  }
+  return subsets;
+}
+
+template <std::size_t capacity>
+consteval std::size_t RegexStateCount(const RegexNfa<capacity>& nfa, const RegexByteClasses& classes, bool search) {
+  return ExploreRegex(nfa, classes, search, [](std::size_t, std::size_t, std::size_t) {}).count;
+}
+
+// States are numbered dead first, then live states that do not accept, then
+// accepting ones, so a single unsigned compare tells a scan to stop. A
+// transition holds the row offset, target state times class count, which
+// saves a multiply per byte.
+template <typename Offset, std::size_t table_size>
+struct RegexDfa {
+  std::array<Offset, table_size> transitions{};
+  Offset start = 0;
+  Offset accepting_from = 0;
+};
+
+template <std::size_t states, std::size_t class_count, std::size_t capacity>
+consteval auto BuildRegexDfa(const RegexNfa<capacity>& nfa, const RegexByteClasses& classes, bool search) {
+  using Offset = std::conditional_t<states * class_count <= 0xFFFF, std::uint16_t, std::uint32_t>;
+  std::array<std::size_t, states * class_count> targets{};
+  const auto subsets = ExploreRegex(nfa, classes, search, [&targets](std::size_t state, std::size_t byte_class, std::size_t target) {
+    targets[state * class_count + byte_class] = target;
+  });
+
+  std::array<std::size_t, states> renumbered{};
+  std::size_t next = 1;
+  for (const bool accepting : {false, true}) {
+    for (std::size_t state = 1; state < states; ++state) {
+      if (subsets.accepting[state] == accepting) {
+        renumbered[state] = next++;
+      }
+    }
+  }
+
+  RegexDfa<Offset, states * class_count> dfa;
+  for (std::size_t state = 1; state < states; ++state) {
+    for (std::size_t byte_class = 0; byte_class < class_count; ++byte_class) {
+      const auto target = renumbered[targets[state * class_count + byte_class]];
+      dfa.transitions[renumbered[state] * class_count + byte_class] = static_cast<Offset>(target * class_count);
+    }
+  }
+  const auto accepting_count = static_cast<std::size_t>(std::count(subsets.accepting.begin(), subsets.accepting.begin() + states, true));
+  dfa.start = static_cast<Offset>(renumbered[1] * class_count);
+  dfa.accepting_from = static_cast<Offset>((states - accepting_count) * class_count);
+  return dfa;
+}
+
+inline constexpr std::size_t MaxRegexPrefix = 32;
+
+// Bytes every match starts with, read off the anchored automaton: while the
+// current state does not accept and a single byte leads anywhere but the
+// dead state, that byte is part of the prefix.
+struct RegexPrefix {
+  std::array<char, MaxRegexPrefix> bytes{};
+  std::size_t size = 0;
+};
+
+template <typename Dfa>
+consteval RegexPrefix LiteralPrefix(const Dfa& dfa, const RegexByteClasses& classes) {
+  RegexPrefix prefix;
+  std::size_t state = dfa.start;
+  while (prefix.size < MaxRegexPrefix && state < dfa.accepting_from) {
+    std::size_t live = 0;
+    std::size_t only = 0;
+    for (std::size_t byte_class = 0; byte_class < classes.count; ++byte_class) {
+      if (dfa.transitions[state + byte_class] != 0) {
+        ++live;
+        only = byte_class;
+      }
+    }
+    if (live != 1 || classes.sizes[only] != 1) {
+      break;
+    }
+    prefix.bytes[prefix.size++] = static_cast<char>(classes.representative[only]);
+    state = dfa.transitions[state + only];
+  }
+  return prefix;
+}
+
+// First position at or after `from` where prefix occurs in text, text.Size()
+// if none. The AVX2 path compares the first and last prefix byte against 32
+// positions at once and only checks the middle bytes of positions where both
+// agree.
+template <RegexPrefix prefix>
+constexpr std::size_t FindRegexPrefix(Span<const char> text, std::size_t from) noexcept {
+  constexpr std::size_t length = prefix.size;
+  const std::size_t size = text.Size();
+  if (size < length) {
+    return size;
+  }
+  const std::size_t last = size - length;
+  const char* data = text.Data();
+  std::size_t i = from;
+  if (!std::is_constant_evaluated()) {
+#if defined(__AVX2__)
+    const __m256i first_byte = _mm256_set1_epi8(prefix.bytes[0]);
+    const __m256i last_byte = _mm256_set1_epi8(prefix.bytes[length - 1]);
+    for (; i + 32 <= last + 1; i += 32) {
+      const __m256i firsts = _mm256_cmpeq_epi8(first_byte, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+      const __m256i lasts =
+          _mm256_cmpeq_epi8(last_byte, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + length - 1)));
+      for (auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(firsts, lasts))); mask != 0;
+           mask &= mask - 1) {
+        const std::size_t candidate = i + static_cast<std::size_t>(std::countr_zero(mask));
+        if constexpr (length <= 2) {
+          return candidate;
+        } else if (std::memcmp(data + candidate + 1, prefix.bytes.data() + 1, length - 2) == 0) {
+          return candidate;
+        }
+      }
+    }
+#else
+    while (i <= last) {
+      const auto* found = static_cast<const char*>(std::memchr(data + i, prefix.bytes[0], last - i + 1));
+      if (found == nullptr) {
+        return size;
+      }
+      i = static_cast<std::size_t>(found - data);
+      if (std::memcmp(found + 1, prefix.bytes.data() + 1, length - 1) == 0) {
+        return i;
+      }
+      ++i;
+    }
+    return size;
+#endif
+  }
+  for (; i <= last; ++i) {
+    if (std::equal(prefix.bytes.begin(), prefix.bytes.begin() + length, data + i)) {
+      return i;
+    }
+  }
+  return size;
+}
+
+} // namespace detail
+
+
+// CompiledRegex
+//
+// Compiles pattern at compile time into a DFA over byte classes, stored in
+// constexpr tables, see detail::RegexParser for the grammar. Match tests the
+// whole text, Search any part of it. When every match starts with the same
+// literal bytes, Search skips text with a SIMD scan for that prefix while no
+// partial match is in progress.
+template <auto pattern>
+requires std::convertible_to<decltype(pattern), std::string_view>
+class CompiledRegex {
+ private:
+  static constexpr auto nfa_ = detail::RegexParser<4 * std::string_view{pattern}.size() + 4>{std::string_view{pattern}}.Parse();
+  static constexpr auto classes_ = detail::ByteClassesOf(nfa_);
+
+  static constexpr auto anchored_ =
+      detail::BuildRegexDfa<detail::RegexStateCount(nfa_, classes_, false), classes_.count>(nfa_, classes_, false);
+  static constexpr auto search_ =
+      detail::BuildRegexDfa<detail::RegexStateCount(nfa_, classes_, true), classes_.count>(nfa_, classes_, true);
+  static constexpr auto prefix_ = detail::LiteralPrefix(anchored_, classes_);
+
+  template <typename Dfa>
+  static constexpr std::size_t Next(const Dfa& dfa, std::size_t state, char byte) noexcept {
+    return dfa.transitions[state + classes_.of[static_cast<unsigned char>(byte)]];
+  }
+
+ public:
+  static constexpr std::string_view Prefix() noexcept {
+    return {prefix_.bytes.data(), prefix_.size};
+  }
+
+  static constexpr std::size_t StateCount() noexcept {
+    return anchored_.transitions.size() / classes_.count;
+  }
+
+  static constexpr bool Match(Span<const char> text) noexcept {
+    std::size_t state = anchored_.start;
+    for (const char byte : text) {
+      state = Next(anchored_, state, byte);
+      if (state == 0) {
+        return false;
+      }
+    }
+    return state >= anchored_.accepting_from;
+  }
+
+  static constexpr bool Search(Span<const char> text) noexcept {
+    if constexpr (nfa_.anchored_start) {
+      return SearchAnchored(text);
+    }
+    const std::size_t size = text.Size();
+    std::size_t state = search_.start;
+    if (!nfa_.anchored_end && state >= search_.accepting_from) {
+      return true;
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+      if constexpr (prefix_.size > 0) {
+        if (state == search_.start) {
+          i = detail::FindRegexPrefix<prefix_>(text, i);
+          if (i == size) {
+            return false;
+          }
+        }
+      }
+      state = Next(search_, state, text[i]);
+      if (!nfa_.anchored_end && state >= search_.accepting_from) {
+        return true;
+      }
+    }
+    return state >= search_.accepting_from;
+  }
+
+ private:
+  // With "^" only matches starting at 0 count, which the anchored automaton
+  // decides, stopping at the first accepting state unless "$" also applies.
+  static constexpr bool SearchAnchored(Span<const char> text) noexcept {
+    if constexpr (nfa_.anchored_end) {
+      return Match(text);
+    }
+    std::size_t state = anchored_.start;
+    if (state >= anchored_.accepting_from) {
+      return true;
+    }
+    for (const char byte : text) {
+      state = Next(anchored_, state, byte);
+      if (state - 1 >= std::size_t{anchored_.accepting_from} - 1) {
+        return state != 0;
+      }
+    }
+    return false;
+  }
+};
+
+template <auto pattern>
+constexpr bool RegexMatch(Span<const char> text) noexcept {
+  return CompiledRegex<pattern>::Match(text);
+}
+
+template <auto pattern>
+constexpr bool RegexSearch(Span<const char> text) noexcept {
+  return CompiledRegex<pattern>::Search(text);
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../span/Span.hpp"
+#include "../type_lists/type_lists.hpp"
+#include "../type_lists/value_types.hpp"
+
+namespace detail {
+
+template <typename Field>
+inline constexpr bool IsVariableField =
+  std::is_same_v<Field, std::string_view> || std::is_same_v<Field, Span<const std::byte>>;
+
+template <typename Field>
+concept SerializableField = IsVariableField<Field> || std::is_trivially_copyable_v<Field>;
+
+using FieldLength = std::uint32_t;
+
+// A variable-length field occupies its length in the fixed part, its bytes
+// follow the fixed part in declaration order.
+template <typename Field>
+inline constexpr std::size_t FixedFieldSize = IsVariableField<Field> ? sizeof(FieldLength) : sizeof(Field);
+
+template <typename Offset, typename Field>
+using AddFieldSize = value_types::ValueTag<Offset::Value + FixedFieldSize<Field>>;
+
+template <typename Offsets>
+struct OffsetArray;
+
+template <auto... offsets>
+struct OffsetArray<type_tuples::TTuple<value_types::ValueTag<offsets>...>> {
+  static constexpr std::array<std::size_t, sizeof...(offsets)> Value{offsets...};
+};
+
+template <typename T>
+T LoadField(const std::byte* data) noexcept {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+template <typename Field>
+Span<const std::byte> VariableBytes(const Field& value) noexcept {
+  if constexpr (std::is_same_v<Field, std::string_view>) {
+    return {reinterpret_cast<const std::byte*>(value.data()), value.size()};
+  } else {
+    return value;
+  }
+}
+
+template <typename Field>
+Field MakeVariableField(const std::byte* data, std::size_t size) noexcept {
+  if constexpr (std::is_same_v<Field, std::string_view>) {
+    return {reinterpret_cast<const char*>(data), size};
+  } else {
+    return {data, size};
+  }
+}
+
+// Whether the field's length fits the FieldLength stored in the fixed part.
+template <typename Field>
+bool FitsFieldLength(const Field& value) noexcept {
+  if constexpr (IsVariableField<Field>) {
+    return VariableBytes(value).Size() <= std::numeric_limits<FieldLength>::max();
+  } else {
+    return true;
+  }
+}
+
+template <typename Field>
+std::size_t VariableSize(const Field& value) noexcept {
+  if constexpr (IsVariableField<Field>) {
+    return VariableBytes(value).Size();
+  } else {
+    return 0;
+  }
+}
+
+} // namespace detail
+
+
+template <typename Schema>
+class Serializer;
+
+// Serializer
+//
+// Binary encoding of records described by a TTuple schema. Fixed-size fields
+// are stored at compile-time offsets in native byte order, std::string_view
+// and Span<const std::byte> fields store a 32-bit length there and their
+// bytes in a tail after the fixed part. Encoding fails like an undersized
+// buffer when a variable-length field is longer than 4 GiB - 1.
+template <detail::SerializableField... Fields>
+class Serializer<type_tuples::TTuple<Fields...>> {
+  static_assert(sizeof...(Fields) > 0, "schema must have at least one field");
+
+ private:
+  using FieldList = type_lists::FromTuple<type_tuples::TTuple<Fields...>>;
+
+  static constexpr auto offsets_ = detail::OffsetArray<type_lists::ToTuple<
+    type_lists::Scanl<detail::AddFieldSize, value_types::ValueTag<std::size_t{0}>, FieldList>>>::Value;
+
+  static constexpr std::array<bool, sizeof...(Fields)> variable_{detail::IsVariableField<Fields>...};
+
+ public:
+  using Record = std::tuple<Fields...>;
+
+  template <std::size_t index>
+  using Field = typename type_lists::Drop<index, FieldList>::Head;
+
+  static constexpr bool HasVariableFields = (detail::IsVariableField<Fields> || ...);
+
+  static constexpr std::size_t FieldCount() noexcept {
+    return sizeof...(Fields);
+  }
+
+  static constexpr std::size_t FixedSize() noexcept {
+    return offsets_.back();
+  }
+
+  template <std::size_t index>
+  static constexpr std::size_t Offset() noexcept {
+    return offsets_[index];
+  }
+
+  static std::size_t EncodedSize(const Fields&... values) noexcept {
+    return (FixedSize() + ... + detail::VariableSize(values));
+  }
+
+  static std::size_t EncodedSize(const Record& record) noexcept {
+    return std::apply([](const auto&... values) { return EncodedSize(values...); }, record);
+  }
+
+  static std::optional<std::size_t> Encode(Span<std::byte> out, const Fields&... values) noexcept {
+    const auto size = EncodedSize(values...);
+    if (size > out.Size() || !FieldsFit(values...)) {
+      return std::nullopt;
+    }
+    EncodeUnchecked(out.Data(), values...);
+    return size;
+  }
+
+  static std::optional<std::size_t> Encode(Span<std::byte> out, const Record& record) noexcept {
+    return std::apply([out](const auto&... values) { return Encode(out, values...); }, record);
+  }
+
+  // Writes the records back to back after a single bounds check.
+  static std::optional<std::size_t> EncodeBatch(Span<std::byte> out, Span<const Record> records) noexcept {
+    std::size_t size = records.Size() * FixedSize();
+    if constexpr (HasVariableFields) {
+      size = 0;
+      for (const auto& record : records) {
+        if (!std::apply([](const auto&... values) { return FieldsFit(values...); }, record)) {
+          return std::nullopt;
+        }
+        size += EncodedSize(record);
+      }
+    }
+    if (size > out.Size()) {
+      return std::nullopt;
+    }
+
+    auto* cursor = out.Data();
+    for (const auto& record : records) {
+      cursor = std::apply([cursor](const auto&... values) { return EncodeUnchecked(cursor, values...); }, record);
+    }
+    return size;
+  }
+
+  // Non-owning view of an encoded record, fields are read on access and
+  // variable-length fields point into the encoded buffer.
+  class View {
+   public:
+    explicit View(const std::byte* data) noexcept
+      : data_{data} {
+    }
+
+    template <std::size_t index>
+    Field<index> Get() const noexcept {
+      using T = Field<index>;
+      if constexpr (detail::IsVariableField<T>) {
+        return detail::MakeVariableField<T>(data_ + FixedSize() + TailOffset<index>(), Length<index>());
+      } else {
+        return detail::LoadField<T>(data_ + Offset<index>());
+      }
+    }
+
+    Record ToRecord() const noexcept {
+      return [this]<std::size_t... indices>(std::index_sequence<indices...>) {
+        return Record{Get<indices>()...};
+      }(std::index_sequence_for<Fields...>{});
+    }
+
+    std::size_t SizeBytes() const noexcept {
+      return FixedSize() + TailOffset<sizeof...(Fields)>();
+    }
+
+    const std::byte* Data() const noexcept {
+      return data_;
+    }
+
+   private:
+    template <std::size_t index>
+    std::size_t Length() const noexcept {
+      return detail::LoadField<detail::FieldLength>(data_ + Offset<index>());
+    }
+
+    template <std::size_t index>
+    std::size_t TailOffset() const noexcept {
+      return [this]<std::size_t... indices>(std::index_sequence<indices...>) {
+        return (std::size_t{0} + ... + (variable_[indices] ? Length<indices>() : 0));
+      }(std::make_index_sequence<index>{});
+    }
+
+    const std::byte* data_;
+  };
+
+  static std::optional<View> Decode(Span<const std::byte> in) noexcept {
+    if (in.Size() < FixedSize()) {
+      return std::nullopt;
+    }
+    const View view{in.Data()};
+    if constexpr (HasVariableFields) {
+      if (in.Size() < view.SizeBytes()) {
+        return std::nullopt;
+      }
+    }
+    return view;
+  }
+
+  // Random access into a batch of records without variable-length fields.
+  static std::optional<View> DecodeAt(Span<const std::byte> in, std::size_t index) noexcept
+  requires (!HasVariableFields) {
+    if ((index + 1) * FixedSize() > in.Size()) {
+      return std::nullopt;
+    }
+    return View{in.Data() + index * FixedSize()};
+  }
+
+  // Calls func with a View of every record in the batch. Returns the number
+  // of records, or nullopt if the buffer ends inside a record.
+  template <typename Func>
+  static std::optional<std::size_t> ForEach(Span<const std::byte> in, Func&& func) {
+    std::size_t count = 0;
+    for (std::size_t offset = 0; offset < in.Size(); ++count) {
+      const auto view = Decode(in.Last(in.Size() - offset));
+      if (!view) {
+        return std::nullopt;
+      }
+      func(*view);
+      offset += view->SizeBytes();
+    }
+    return count;
+  }
+
+ private:
+  static bool FieldsFit(const Fields&... values) noexcept {
+    return (detail::FitsFieldLength(values) && ...);
+  }
+
+  static std::byte* EncodeUnchecked(std::byte* out, const Fields&... values) noexcept {
+    auto* tail = out + FixedSize();
+    [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+      ([&](const auto& value) {
+        using T = std::remove_cvref_t<decltype(value)>;
+        if constexpr (detail::IsVariableField<T>) {
+          const auto bytes = detail::VariableBytes(value);
+          assert(bytes.Size() <= std::numeric_limits<detail::FieldLength>::max());
+          const auto length = static_cast<detail::FieldLength>(bytes.Size());
+          std::memcpy(out + Offset<indices>(), &length, sizeof(length));
+          if (length != 0) {
+            std::memcpy(tail, bytes.Data(), length);
+          }
+          tail += length;
+        } else {
+          std::memcpy(out + Offset<indices>(), &value, sizeof(T));
+        }
+      }(values), ...);
+    }(std::index_sequence_for<Fields...>{});
+    return tail;
+  }
+};
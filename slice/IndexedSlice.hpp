@@ -0,0 +1,405 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../span/Span.hpp"
+#include "Prefetch.hpp"
+#include "Slice.hpp"
+#include "ZipSlice.hpp"
+
+enum class GatherOrder {
+  // Visit the indices as given.
+  AsGiven,
+  // Visit in increasing index order, equal indices in their given order.
+  Sorted,
+  // Visit bucket by bucket of 2^bucket_bits consecutive indices, given order
+  // inside a bucket. Linear time, most of the locality of Sorted.
+  Bucketed,
+};
+
+
+// GatherPlan
+//
+// Visit order for a Span of indices, computed once and reused for every
+// column gathered or scattered through the same indices. Duplicate indices
+// keep their relative order, so scatters through a plan end with the same
+// values as scatters in the given order.
+class GatherPlan {
+ public:
+  explicit GatherPlan(Span<const std::uint32_t> indices, GatherOrder order = GatherOrder::Bucketed,
+                      unsigned bucket_bits = 14)
+    : entries_(indices.Size()) {
+    assert(indices.Size() <= std::numeric_limits<std::uint32_t>::max());
+    for (std::size_t position = 0; position < indices.Size(); ++position) {
+      entries_[position] = Entry(indices[position], position);
+    }
+    if (order == GatherOrder::Sorted) {
+      std::sort(entries_.begin(), entries_.end());
+    } else if (order == GatherOrder::Bucketed) {
+      Bucket(bucket_bits);
+    }
+  }
+
+  std::size_t Size() const noexcept {
+    return entries_.size();
+  }
+
+  // Index of the element visited at step i and its position in the index span.
+  std::uint32_t Index(std::size_t i) const noexcept {
+    return static_cast<std::uint32_t>(entries_[i] >> 32);
+  }
+
+  std::uint32_t Position(std::size_t i) const noexcept {
+    return static_cast<std::uint32_t>(entries_[i]);
+  }
+
+ private:
+  static std::uint64_t Entry(std::uint32_t index, std::size_t position) noexcept {
+    return std::uint64_t{index} << 32 | position;
+  }
+
+  void Bucket(unsigned bucket_bits) {
+    std::uint32_t max_index = 0;
+    for (const auto entry : entries_) {
+      max_index = std::max(max_index, static_cast<std::uint32_t>(entry >> 32));
+    }
+    const std::size_t bucket_count = (std::size_t{max_index} >> bucket_bits) + 1;
+
+    std::vector<std::size_t> offsets(bucket_count + 1);
+    for (const auto entry : entries_) {
+      ++offsets[(entry >> 32 >> bucket_bits) + 1];
+    }
+    for (std::size_t b = 1; b <= bucket_count; ++b) {
+      offsets[b] += offsets[b - 1];
+    }
+    std::vector<std::uint64_t> bucketed(entries_.size());
+    for (const auto entry : entries_) {
+      bucketed[offsets[entry >> 32 >> bucket_bits]++] = entry;
+    }
+    entries_.swap(bucketed);
+  }
+
+  std::vector<std::uint64_t> entries_;
+};
+
+
+// IndexedSlice
+//
+// Element i is base[indices[i]]. Besides element access it offers bulk
+// Gather into and Scatter from contiguous spans that prefetch a fixed
+// distance ahead and use hardware gather (AVX2) and scatter (AVX-512)
+// instructions for 4- and 8-byte elements when compiled for them.
+template <typename T, std::ptrdiff_t stride = dynamic_stride>
+class IndexedSlice {
+ public:
+  using element_type    = T;
+  using value_type      = std::remove_cv_t<T>;
+  using size_type       = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference       = T&;
+
+  static constexpr std::size_t DefaultPrefetchDistance = 32;
+
+  class iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = IndexedSlice::value_type;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = T&;
+
+    constexpr iterator() noexcept = default;
+
+    constexpr iterator(Slice<T, dynamic_extent, stride> base, const std::uint32_t* indices, std::size_t index) noexcept
+      : base_{base}
+      , indices_{indices}
+      , index_{index} {
+    }
+
+    [[nodiscard]] constexpr reference operator*() const noexcept {
+      return base_[indices_[index_]];
+    }
+
+    constexpr reference operator[](const difference_type offset) const noexcept {
+      return base_[indices_[index_ + offset]];
+    }
+
+    constexpr iterator& operator++() noexcept {
+      ++index_;
+      return *this;
+    }
+
+    constexpr iterator operator++(int) noexcept {
+      iterator tmp{*this};
+      ++index_;
+      return tmp;
+    }
+
+    constexpr iterator& operator--() noexcept {
+      --index_;
+      return *this;
+    }
+
+    constexpr iterator operator--(int) noexcept {
+      iterator tmp{*this};
+      --index_;
+      return tmp;
+    }
+
+    constexpr iterator& operator+=(const difference_type offset) noexcept {
+      index_ += offset;
+      return *this;
+    }
+
+    constexpr iterator& operator-=(const difference_type offset) noexcept {
+      index_ -= offset;
+      return *this;
+    }
+
+    [[nodiscard]] constexpr iterator operator+(const difference_type offset) const noexcept {
+      return {base_, indices_, index_ + offset};
+    }
+
+    friend constexpr iterator operator+(const difference_type offset, iterator iter) noexcept {
+      return iter + offset;
+    }
+
+    [[nodiscard]] constexpr iterator operator-(const difference_type offset) const noexcept {
+      return {base_, indices_, index_ - offset};
+    }
+
+    [[nodiscard]] constexpr difference_type operator-(const iterator& other) const noexcept {
+      return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    [[nodiscard]] constexpr bool operator==(const iterator& rhs) const noexcept {
+      return index_ == rhs.index_;
+    }
+
+    [[nodiscard]] constexpr auto operator<=>(const iterator& rhs) const noexcept {
+      return index_ <=> rhs.index_;
+    }
+
+   private:
+    // Copies of the view's fields, so the iterator outlives the view.
+    Slice<T, dynamic_extent, stride> base_;
+    const std::uint32_t* indices_ = nullptr;
+    std::size_t index_ = 0;
+  };
+
+  constexpr IndexedSlice(Slice<T, dynamic_extent, stride> base, Span<const std::uint32_t> indices) noexcept
+    : base_{base}
+    , indices_{indices} {
+  }
+
+  constexpr std::size_t Size() const noexcept {
+    return indices_.Size();
+  }
+
+  constexpr bool Empty() const noexcept {
+    return indices_.Empty();
+  }
+
+  constexpr const Slice<T, dynamic_extent, stride>& Base() const noexcept {
+    return base_;
+  }
+
+  constexpr Span<const std::uint32_t> Indices() const noexcept {
+    return indices_;
+  }
+
+  constexpr reference operator[](std::size_t index) const noexcept {
+    assert(index < Size());
+    return base_[indices_[index]];
+  }
+
+  [[nodiscard]] constexpr iterator begin() const noexcept {
+    return {base_, indices_.Data(), 0};
+  }
+
+  [[nodiscard]] constexpr iterator end() const noexcept {
+    return {base_, indices_.Data(), Size()};
+  }
+
+  // out[i] = base[indices[i]].
+  void Gather(Span<value_type> out, std::size_t prefetch_distance = DefaultPrefetchDistance) const noexcept {
+    assert(out.Size() == Size());
+    const std::size_t size = Size();
+    const auto* indices = indices_.Data();
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    if constexpr ((sizeof(T) == 4 || sizeof(T) == 8) && std::is_trivially_copyable_v<T>) {
+      if (HardwareIndexable()) {
+        i = GatherVector(out.Data(), prefetch_distance);
+      }
+    }
+#endif
+    for (const auto prefetched = PrefetchedSteps(size, prefetch_distance); i < prefetched; ++i) {
+      Prefetch<PrefetchMode::Read>(indices[i + prefetch_distance]);
+      out[i] = At(indices[i]);
+    }
+    for (; i < size; ++i) {
+      out[i] = At(indices[i]);
+    }
+  }
+
+  // out[i] = base[plan.Index(k)] for i = plan.Position(k), visiting in plan order.
+  void Gather(Span<value_type> out, const GatherPlan& plan, std::size_t prefetch_distance = DefaultPrefetchDistance) const noexcept {
+    assert(out.Size() == Size() && plan.Size() == Size());
+    const std::size_t size = plan.Size();
+    std::size_t k = 0;
+    for (const auto prefetched = PrefetchedSteps(size, prefetch_distance); k < prefetched; ++k) {
+      Prefetch<PrefetchMode::Read>(plan.Index(k + prefetch_distance));
+      out.Data()[plan.Position(k)] = At(plan.Index(k));
+    }
+    for (; k < size; ++k) {
+      out.Data()[plan.Position(k)] = At(plan.Index(k));
+    }
+  }
+
+  // base[indices[i]] = in[i]. With duplicate indices the last one wins.
+  void Scatter(Span<const value_type> in, std::size_t prefetch_distance = DefaultPrefetchDistance) const noexcept
+  requires (!std::is_const_v<T>) {
+    assert(in.Size() == Size());
+    const std::size_t size = Size();
+    const auto* indices = indices_.Data();
+    std::size_t i = 0;
+#if defined(__AVX512F__)
+    if constexpr ((sizeof(T) == 4 || sizeof(T) == 8) && std::is_trivially_copyable_v<T>) {
+      if (HardwareIndexable()) {
+        i = ScatterVector(in.Data(), prefetch_distance);
+      }
+    }
+#endif
+    for (const auto prefetched = PrefetchedSteps(size, prefetch_distance); i < prefetched; ++i) {
+      Prefetch<PrefetchMode::Write>(indices[i + prefetch_distance]);
+      At(indices[i]) = in[i];
+    }
+    for (; i < size; ++i) {
+      At(indices[i]) = in[i];
+    }
+  }
+
+  void Scatter(Span<const value_type> in, const GatherPlan& plan, std::size_t prefetch_distance = DefaultPrefetchDistance) const noexcept
+  requires (!std::is_const_v<T>) {
+    assert(in.Size() == Size() && plan.Size() == Size());
+    const std::size_t size = plan.Size();
+    std::size_t k = 0;
+    for (const auto prefetched = PrefetchedSteps(size, prefetch_distance); k < prefetched; ++k) {
+      Prefetch<PrefetchMode::Write>(plan.Index(k + prefetch_distance));
+      At(plan.Index(k)) = in.Data()[plan.Position(k)];
+    }
+    for (; k < size; ++k) {
+      At(plan.Index(k)) = in.Data()[plan.Position(k)];
+    }
+  }
+
+ private:
+  // Steps that still have an element prefetch_distance ahead, none for distance 0.
+  static std::size_t PrefetchedSteps(std::size_t size, std::size_t prefetch_distance) noexcept {
+    return prefetch_distance != 0 && size > prefetch_distance ? size - prefetch_distance : 0;
+  }
+
+  T& At(std::uint32_t index) const noexcept {
+    assert(index < base_.Size());
+    return base_.Data()[static_cast<std::ptrdiff_t>(index) * base_.Stride()];
+  }
+
+  template <PrefetchMode mode>
+  void Prefetch(std::uint32_t index) const noexcept {
+    detail::PrefetchAddress<mode>(reinterpret_cast<std::uintptr_t>(base_.Data()) +
+                                  static_cast<std::ptrdiff_t>(index) * base_.Stride() * static_cast<std::ptrdiff_t>(sizeof(T)));
+  }
+
+  // Vector gathers and scatters take signed 32-bit element offsets.
+  bool HardwareIndexable() const noexcept {
+    const auto stride_magnitude = static_cast<std::size_t>(base_.Stride() < 0 ? -base_.Stride() : base_.Stride());
+    return base_.Size() * stride_magnitude <= std::size_t{std::numeric_limits<std::int32_t>::max()};
+  }
+
+#if defined(__AVX2__)
+  // Processes whole vectors and returns the number of elements done.
+  std::size_t GatherVector(value_type* out, std::size_t prefetch_distance) const noexcept {
+    const auto* indices = reinterpret_cast<const __m128i*>(indices_.Data());
+    const auto* base = base_.Data();
+    const std::size_t size = Size();
+    constexpr std::size_t lanes = 4;
+    const __m128i strides = _mm_set1_epi32(static_cast<std::int32_t>(base_.Stride()));
+
+    std::size_t i = 0;
+    for (; i + 2 * lanes <= size; i += 2 * lanes) {
+      if (prefetch_distance != 0 && i + prefetch_distance + 2 * lanes <= size) {
+        for (std::size_t lane = 0; lane < 2 * lanes; ++lane) {
+          Prefetch<PrefetchMode::Read>(indices_[i + prefetch_distance + lane]);
+        }
+      }
+      const __m128i low = _mm_mullo_epi32(_mm_loadu_si128(indices + i / lanes), strides);
+      const __m128i high = _mm_mullo_epi32(_mm_loadu_si128(indices + i / lanes + 1), strides);
+      if constexpr (sizeof(T) == 4) {
+        const auto* source = reinterpret_cast<const int*>(base);
+        const __m256i offsets = _mm256_set_m128i(high, low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_i32gather_epi32(source, offsets, 4));
+      } else {
+        const auto* source = reinterpret_cast<const long long*>(base);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_i32gather_epi64(source, low, 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + lanes), _mm256_i32gather_epi64(source, high, 8));
+      }
+    }
+    return i;
+  }
+#endif
+
+#if defined(__AVX512F__)
+  std::size_t ScatterVector(const value_type* in, std::size_t prefetch_distance) const noexcept {
+    const auto* indices = indices_.Data();
+    auto* base = base_.Data();
+    const std::size_t size = Size();
+    // One 64-byte vector of values per step.
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    const auto stride_value = static_cast<std::int32_t>(base_.Stride());
+
+    std::size_t i = 0;
+    for (; i + lanes <= size; i += lanes) {
+      if (prefetch_distance != 0 && i + prefetch_distance + lanes <= size) {
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+          Prefetch<PrefetchMode::Write>(indices[i + prefetch_distance + lane]);
+        }
+      }
+      const __m512i values = _mm512_loadu_si512(in + i);
+      if constexpr (sizeof(T) == 4) {
+        const __m512i offsets = _mm512_mullo_epi32(_mm512_loadu_si512(indices + i), _mm512_set1_epi32(stride_value));
+        _mm512_i32scatter_epi32(base, offsets, values, 4);
+      } else {
+        const __m256i offsets = _mm256_mullo_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i)),
+                                                   _mm256_set1_epi32(stride_value));
+        _mm512_i32scatter_epi64(base, offsets, values, 8);
+      }
+    }
+    return i;
+  }
+#endif
+
+  Slice<T, dynamic_extent, stride> base_;
+  Span<const std::uint32_t> indices_;
+};
+
+// View of base[indices[i]] over any Span or Slice.
+template <typename Range>
+constexpr auto Indexed(const Range& base, Span<const std::uint32_t> indices) noexcept {
+  using BaseSlice = decltype(detail::AsSlice(base));
+  using T = typename BaseSlice::element_type;
+  constexpr auto stride = detail::SliceStride<BaseSlice>::value;
+  const auto slice = detail::AsSlice(base);
+  return IndexedSlice<T, stride>{{slice.Data(), slice.Size(), slice.Stride()}, indices};
+}
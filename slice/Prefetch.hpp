@@ -0,0 +1,230 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+enum class PrefetchMode {
+  Read,
+  Write,
+  // Fetches the line for writing without polluting the cache hierarchy,
+  // pair with StreamStore for streaming writes.
+  NonTemporal,
+};
+
+namespace detail {
+
+template <PrefetchMode mode>
+inline void PrefetchAddress(std::uintptr_t address) noexcept {
+#if defined(__GNUC__)
+  const auto* ptr = reinterpret_cast<const void*>(address);
+  if constexpr (mode == PrefetchMode::Read) {
+    __builtin_prefetch(ptr, 0, 3);
+  } else if constexpr (mode == PrefetchMode::Write) {
+    __builtin_prefetch(ptr, 1, 3);
+  } else {
+    __builtin_prefetch(ptr, 1, 0);
+  }
+#else
+  (void)address;
+#endif
+}
+
+} // namespace detail
+
+
+// Non-temporal store of a 4- or 8-byte value, plain store otherwise.
+// Call StreamFence once the streaming loop is done.
+template <typename T>
+requires std::is_trivially_copyable_v<T>
+inline void StreamStore(T& destination, const T& value) noexcept {
+#if defined(__SSE2__)
+  if constexpr (sizeof(T) == sizeof(int)) {
+    int bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    _mm_stream_si32(reinterpret_cast<int*>(std::addressof(destination)), bits);
+    return;
+  }
+#if defined(__x86_64__)
+  if constexpr (sizeof(T) == sizeof(long long)) {
+    long long bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    _mm_stream_si64(reinterpret_cast<long long*>(std::addressof(destination)), bits);
+    return;
+  }
+#endif
+#endif
+  destination = value;
+}
+
+inline void StreamFence() noexcept {
+#if defined(__SSE2__)
+  _mm_sfence();
+#endif
+}
+
+
+// Wraps a contiguous or strided iterator and issues a software prefetch
+// distance bytes ahead of the current element every time it moves. Ahead
+// follows the direction of the move, so a backward traversal prefetches
+// the elements before the current one.
+template <typename Iter, PrefetchMode mode = PrefetchMode::Read>
+class PrefetchIterator {
+ public:
+  using iterator_concept [[maybe_unused]] = std::random_access_iterator_tag;
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type        = std::iter_value_t<Iter>;
+  using difference_type   = std::iter_difference_t<Iter>;
+  using pointer           = decltype(std::to_address(std::declval<Iter>()));
+  using reference         = std::iter_reference_t<Iter>;
+
+  constexpr PrefetchIterator() noexcept = default;
+
+  constexpr PrefetchIterator(Iter iter, std::ptrdiff_t distance_bytes) noexcept
+    : iter_{iter}
+    , distance_bytes_{distance_bytes} {
+  }
+
+  [[nodiscard]] constexpr reference operator*() const noexcept {
+    return *iter_;
+  }
+
+  [[nodiscard]] constexpr pointer operator->() const noexcept {
+    return std::to_address(iter_);
+  }
+
+  constexpr PrefetchIterator& operator++() noexcept {
+    ++iter_;
+    Prefetch(distance_bytes_);
+    return *this;
+  }
+
+  constexpr PrefetchIterator operator++(int) noexcept {
+    PrefetchIterator tmp{*this};
+    ++(*this);
+    return tmp;
+  }
+
+  constexpr PrefetchIterator& operator--() noexcept {
+    --iter_;
+    Prefetch(-distance_bytes_);
+    return *this;
+  }
+
+  constexpr PrefetchIterator operator--(int) noexcept {
+    PrefetchIterator tmp{*this};
+    --*this;
+    return tmp;
+  }
+
+  constexpr PrefetchIterator& operator+=(const difference_type offset) noexcept {
+    iter_ += offset;
+    Prefetch(offset < 0 ? -distance_bytes_ : distance_bytes_);
+    return *this;
+  }
+
+  constexpr PrefetchIterator& operator-=(const difference_type offset) noexcept {
+    iter_ -= offset;
+    Prefetch(offset > 0 ? -distance_bytes_ : distance_bytes_);
+    return *this;
+  }
+
+  [[nodiscard]] constexpr PrefetchIterator operator+(const difference_type offset) const noexcept {
+    return {iter_ + offset, distance_bytes_};
+  }
+
+  friend constexpr PrefetchIterator operator+(const difference_type offset, PrefetchIterator iter) noexcept {
+    return iter + offset;
+  }
+
+  [[nodiscard]] constexpr PrefetchIterator operator-(const difference_type offset) const noexcept {
+    return {iter_ - offset, distance_bytes_};
+  }
+
+  [[nodiscard]] constexpr difference_type operator-(const PrefetchIterator& other) const noexcept {
+    return iter_ - other.iter_;
+  }
+
+  constexpr reference operator[](const difference_type offset) const noexcept {
+    return *(iter_ + offset);
+  }
+
+  [[nodiscard]] constexpr bool operator==(const PrefetchIterator& rhs) const noexcept {
+    return iter_ == rhs.iter_;
+  }
+
+  [[nodiscard]] constexpr auto operator<=>(const PrefetchIterator& rhs) const noexcept {
+    return iter_ <=> rhs.iter_;
+  }
+
+  constexpr Iter Base() const noexcept {
+    return iter_;
+  }
+
+  constexpr std::ptrdiff_t DistanceBytes() const noexcept {
+    return distance_bytes_;
+  }
+
+ private:
+  constexpr void Prefetch(std::ptrdiff_t offset_bytes) const noexcept {
+    if (!std::is_constant_evaluated()) {
+      // Integer arithmetic: the target may lie outside the range.
+      detail::PrefetchAddress<mode>(reinterpret_cast<std::uintptr_t>(std::to_address(iter_)) + offset_bytes);
+    }
+  }
+
+  Iter iter_{};
+  std::ptrdiff_t distance_bytes_ = 0;
+};
+
+
+template <typename Iter, PrefetchMode mode = PrefetchMode::Read>
+class PrefetchView {
+ public:
+  using iterator = PrefetchIterator<Iter, mode>;
+
+  constexpr PrefetchView(Iter first, Iter last, std::ptrdiff_t distance_bytes) noexcept
+    : first_{first, distance_bytes}
+    , last_{last, distance_bytes} {
+  }
+
+  [[nodiscard]] constexpr iterator begin() const noexcept {
+    return first_;
+  }
+
+  [[nodiscard]] constexpr iterator end() const noexcept {
+    return last_;
+  }
+
+  constexpr std::size_t Size() const noexcept {
+    return static_cast<std::size_t>(last_ - first_);
+  }
+
+ private:
+  iterator first_;
+  iterator last_;
+};
+
+
+// Traverses a Span or Slice prefetching `distance` elements ahead, that is
+// distance * Stride() * sizeof(T) bytes past the current element.
+template <PrefetchMode mode = PrefetchMode::Read, typename Range>
+constexpr auto Prefetched(const Range& range, std::size_t distance) noexcept {
+  using Iter = decltype(range.begin());
+  using T = std::remove_reference_t<std::iter_reference_t<Iter>>;
+
+  std::ptrdiff_t stride = 1;
+  if constexpr (requires { range.Stride(); }) {
+    stride = range.Stride();
+  }
+  const auto distance_bytes = static_cast<std::ptrdiff_t>(distance) * stride * static_cast<std::ptrdiff_t>(sizeof(T));
+  return PrefetchView<Iter, mode>{range.begin(), range.end(), distance_bytes};
+}
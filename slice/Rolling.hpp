@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../span/Span.hpp"
+#include "Slice.hpp"
+#include "WindowedSlice.hpp"
+
+// CompensatedSum
+//
+// Running floating point sum with Neumaier's variant of Kahan compensation.
+// The rounding error stays near one ulp of the result however many values
+// are added and subtracted, which keeps a sliding sum from drifting.
+template <std::floating_point R>
+class CompensatedSum {
+ public:
+  constexpr void Add(R value) noexcept {
+    const R sum = sum_ + value;
+    if (Magnitude(sum_) >= Magnitude(value)) {
+      compensation_ += (sum_ - sum) + value;
+    } else {
+      compensation_ += (value - sum) + sum_;
+    }
+    sum_ = sum;
+  }
+
+  constexpr void Subtract(R value) noexcept {
+    Add(-value);
+  }
+
+  // Adds added - removed. The rounding error of the difference goes straight
+  // into the compensation, off the dependency chain of the running sum.
+  constexpr void Replace(R added, R removed) noexcept {
+    const R difference = added - removed;
+    const R rounded = difference - added;
+    compensation_ += (added - (difference - rounded)) - (removed + rounded);
+    Add(difference);
+  }
+
+  constexpr R Value() const noexcept {
+    return sum_ + compensation_;
+  }
+
+  constexpr void Reset() noexcept {
+    sum_ = 0;
+    compensation_ = 0;
+  }
+
+ private:
+  static constexpr R Magnitude(R value) noexcept {
+    return value < 0 ? -value : value;
+  }
+
+  R sum_ = 0;
+  R compensation_ = 0;
+};
+
+
+// SlidingExtremum
+//
+// Minimum (Compare = std::less) or maximum (std::greater) of the last
+// `window` values pushed. Values are kept in a monotonic queue on a ring of
+// window slots, each one is pushed and popped once, so Push is amortized O(1).
+template <typename V, typename Compare = std::less<V>>
+class SlidingExtremum {
+ public:
+  explicit SlidingExtremum(std::size_t window, Compare compare = {})
+    : window_{window}
+    , entries_(std::bit_ceil(window))
+    , compare_{compare} {
+    assert(window > 0);
+  }
+
+  void Push(const V& value) {
+    if (count_ > 0 && entries_[head_].position + window_ <= pushed_) {
+      head_ = (head_ + 1) & Mask();
+      --count_;
+    }
+    while (count_ > 0 && !compare_(entries_[(head_ + count_ - 1) & Mask()].value, value)) {
+      --count_;
+    }
+    entries_[(head_ + count_) & Mask()] = {value, pushed_++};
+    ++count_;
+  }
+
+  const V& Extremum() const noexcept {
+    assert(count_ > 0);
+    return entries_[head_].value;
+  }
+
+  void Reset() noexcept {
+    head_ = 0;
+    count_ = 0;
+    pushed_ = 0;
+  }
+
+ private:
+  struct Entry {
+    V value;
+    std::size_t position;
+  };
+
+  std::size_t Mask() const noexcept {
+    return entries_.size() - 1;
+  }
+
+  std::size_t window_;
+  std::vector<Entry> entries_;
+  Compare compare_;
+  std::size_t head_ = 0;
+  std::size_t count_ = 0;
+  std::size_t pushed_ = 0;
+};
+
+namespace detail {
+
+// Bulk kernels work on chunks of windows whose scratch fits in L2. The
+// elements shared by neighbouring chunks are scanned twice, so a chunk spans
+// several windows when windows are long.
+inline constexpr std::size_t RollingChunkElements = 1 << 14;
+
+template <typename Windows>
+std::size_t WindowsPerChunk(const Windows& windows) noexcept {
+  const std::size_t span = std::max(RollingChunkElements, 4 * windows.WindowSize());
+  return std::max<std::size_t>(1, span / windows.Step());
+}
+
+// Elements in the largest chunk, the scratch size a kernel needs.
+template <typename Windows>
+std::size_t LargestWindowChunk(const Windows& windows) noexcept {
+  if (windows.Empty()) {
+    return 0;
+  }
+  return windows.Start(std::min(windows.Size(), WindowsPerChunk(windows)) - 1) + windows.WindowSize();
+}
+
+// Calls func(first_window, last_window, first_element, element_count) for
+// consecutive chunks of windows.
+template <typename Windows, typename Func>
+void ForEachWindowChunk(const Windows& windows, Func&& func) {
+  const std::size_t per_chunk = WindowsPerChunk(windows);
+  for (std::size_t first = 0; first < windows.Size(); first += per_chunk) {
+    const std::size_t last = std::min(windows.Size(), first + per_chunk);
+    func(first, last, windows.Start(first), windows.Start(last - 1) + windows.WindowSize() - windows.Start(first));
+  }
+}
+
+// prefix[i] = sum of values[first + j] - offset for j < i, for i in [0, size].
+template <typename R, typename T, std::ptrdiff_t stride>
+void ShiftedPrefixSums(const Slice<T, dynamic_extent, stride>& values, std::size_t first, std::size_t size, R offset,
+                       R* prefix) noexcept {
+  prefix[0] = 0;
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  // In-register scan of four lanes, then the carry from the previous block.
+  if constexpr (std::is_same_v<std::remove_cv_t<T>, double> && std::is_same_v<R, double>) {
+    if (values.Stride() == 1) {
+      const double* data = values.Data() + first;
+      const __m256d shift = _mm256_set1_pd(offset);
+      __m256d carry = _mm256_setzero_pd();
+      for (; i + 4 <= size; i += 4) {
+        __m256d sums = _mm256_sub_pd(_mm256_loadu_pd(data + i), shift);
+        sums = _mm256_add_pd(sums, _mm256_blend_pd(_mm256_permute4x64_pd(sums, 0x90), _mm256_setzero_pd(), 0x1));
+        sums = _mm256_add_pd(sums, _mm256_permute2f128_pd(sums, sums, 0x08));
+        sums = _mm256_add_pd(sums, carry);
+        _mm256_storeu_pd(prefix + i + 1, sums);
+        carry = _mm256_permute4x64_pd(sums, 0xFF);
+      }
+    }
+  }
+#endif
+  for (; i < size; ++i) {
+    prefix[i + 1] = prefix[i] + (static_cast<R>(values[first + i]) - offset);
+  }
+}
+
+// Van Herk / Gil-Werman: cut each chunk into blocks of one window, scan every
+// block forward and backward, and a window is then the better of the backward
+// scan at its start and the forward scan at its end. Three comparisons per
+// element and no data dependent branches.
+template <typename T, std::size_t window, std::size_t step, std::ptrdiff_t stride, typename Compare>
+void RollingExtremum(const WindowedSlice<T, window, step, stride>& windows, Span<std::remove_cv_t<T>> out, Compare compare) {
+  using V = std::remove_cv_t<T>;
+  assert(out.Size() == windows.Size());
+  const auto& base = windows.Base();
+  const std::size_t window_size = windows.WindowSize();
+  const auto better = [&compare](const V& lhs, const V& rhs) -> const V& {
+    return compare(rhs, lhs) ? rhs : lhs;
+  };
+
+  std::vector<V> forward(LargestWindowChunk(windows));
+  std::vector<V> backward(forward.size());
+  ForEachWindowChunk(windows, [&](std::size_t first_window, std::size_t last_window, std::size_t first, std::size_t count) {
+    for (std::size_t block = 0; block < count; block += window_size) {
+      const std::size_t block_end = std::min(block + window_size, count);
+      forward[block] = base[first + block];
+      for (std::size_t i = block + 1; i < block_end; ++i) {
+        forward[i] = better(forward[i - 1], base[first + i]);
+      }
+      backward[block_end - 1] = base[first + block_end - 1];
+      for (std::size_t i = block_end - 1; i > block; --i) {
+        backward[i - 1] = better(base[first + i - 1], backward[i]);
+      }
+    }
+    for (std::size_t k = first_window; k < last_window; ++k) {
+      const std::size_t start = windows.Start(k) - first;
+      out[k] = better(backward[start], forward[start + window_size - 1]);
+    }
+  });
+}
+
+} // namespace detail
+
+
+// out[k] = sum of window k, updated by the elements entering and leaving
+// between overlapping windows, so the whole series costs O(n) for any
+// window size.
+template <std::floating_point R, typename T, std::size_t window, std::size_t step, std::ptrdiff_t stride>
+void RollingSum(const WindowedSlice<T, window, step, stride>& windows, Span<R> out) noexcept {
+  assert(out.Size() == windows.Size());
+  const auto& base = windows.Base();
+  const std::size_t window_size = windows.WindowSize();
+  const std::size_t step_size = windows.Step();
+  CompensatedSum<R> sum;
+  for (std::size_t k = 0; k < windows.Size(); ++k) {
+    const std::size_t start = windows.Start(k);
+    if (k == 0 || step_size >= window_size) {
+      sum.Reset();
+      for (std::size_t i = start; i < start + window_size; ++i) {
+        sum.Add(static_cast<R>(base[i]));
+      }
+    } else {
+      for (std::size_t i = start - step_size; i < start; ++i) {
+        sum.Replace(static_cast<R>(base[i + window_size]), static_cast<R>(base[i]));
+      }
+    }
+    out[k] = sum.Value();
+  }
+}
+
+// out[k] = mean of window k as a difference of two prefix sums. The prefix
+// sums are taken of the values minus the first window's mean, which keeps
+// them small for series with a level and so limits the cancellation.
+template <std::floating_point R, typename T, std::size_t window, std::size_t step, std::ptrdiff_t stride>
+void RollingMean(const WindowedSlice<T, window, step, stride>& windows, Span<R> out) {
+  assert(out.Size() == windows.Size());
+  if (windows.Empty()) {
+    return;
+  }
+  const auto& base = windows.Base();
+  const std::size_t window_size = windows.WindowSize();
+  const auto divisor = static_cast<R>(window_size);
+
+  CompensatedSum<R> first_window_sum;
+  for (std::size_t i = 0; i < window_size; ++i) {
+    first_window_sum.Add(static_cast<R>(base[i]));
+  }
+  const R offset = first_window_sum.Value() / divisor;
+
+  std::vector<R> prefix(detail::LargestWindowChunk(windows) + 1);
+  detail::ForEachWindowChunk(windows, [&](std::size_t first_window, std::size_t last_window, std::size_t first, std::size_t count) {
+    detail::ShiftedPrefixSums(base, first, count, offset, prefix.data());
+    for (std::size_t k = first_window; k < last_window; ++k) {
+      const std::size_t start = windows.Start(k) - first;
+      out[k] = offset + (prefix[start + window_size] - prefix[start]) / divisor;
+    }
+  });
+}
+
+template <typename T, std::size_t window, std::size_t step, std::ptrdiff_t stride>
+void RollingMin(const WindowedSlice<T, window, step, stride>& windows, Span<std::remove_cv_t<T>> out) {
+  detail::RollingExtremum(windows, out, std::less<std::remove_cv_t<T>>{});
+}
+
+template <typename T, std::size_t window, std::size_t step, std::ptrdiff_t stride>
+void RollingMax(const WindowedSlice<T, window, step, stride>& windows, Span<std::remove_cv_t<T>> out) {
+  detail::RollingExtremum(windows, out, std::greater<std::remove_cv_t<T>>{});
+}
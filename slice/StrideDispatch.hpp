@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "../type_lists/value_types.hpp"
+#include "Slice.hpp"
+
+// Strides most kernels see in practice, the default dispatch list.
+using CommonStrides = value_types::VTuple<std::ptrdiff_t, 1, 2, 3, 4, 8>;
+
+namespace detail {
+
+template <typename Strides>
+struct StrideDispatcher;
+
+template <auto... strides>
+struct StrideDispatcher<type_tuples::TTuple<value_types::ValueTag<strides>...>> {
+  static_assert(((strides != dynamic_stride) && ...), "dispatch strides must be static");
+
+  template <typename T, std::size_t extent, typename Func>
+  static constexpr decltype(auto) Dispatch(Slice<T, extent, dynamic_stride> slice, Func& func) {
+    using Result = std::invoke_result_t<Func&, Slice<T, extent, dynamic_stride>>;
+    static_assert((std::is_same_v<Result, std::invoke_result_t<Func&, Slice<T, extent, strides>>> && ...),
+                  "every instantiation of the callable must return the same type");
+    return Try<strides...>(slice, func);
+  }
+
+ private:
+  template <std::ptrdiff_t stride, std::ptrdiff_t... rest, typename T, std::size_t extent, typename Func>
+  static constexpr decltype(auto) Try(Slice<T, extent, dynamic_stride> slice, Func& func) {
+    if (slice.Stride() == stride) {
+      return std::invoke(func, Slice<T, extent, stride>{slice.Data(), slice.Size()});
+    }
+    if constexpr (sizeof...(rest) > 0) {
+      return Try<rest...>(slice, func);
+    } else {
+      return std::invoke(func, slice);
+    }
+  }
+
+  template <typename T, std::size_t extent, typename Func>
+  static constexpr decltype(auto) Try(Slice<T, extent, dynamic_stride> slice, Func& func) {
+    return std::invoke(func, slice);
+  }
+};
+
+} // namespace detail
+
+
+// Calls func with the slice retyped to Slice<T, extent, K> when its runtime
+// stride is one of Strides, a value_types::VTuple, and with the slice as is
+// otherwise. func is instantiated once per listed stride plus the fallback.
+template <typename Strides = CommonStrides, typename T, std::size_t extent, std::ptrdiff_t stride, typename Func>
+constexpr decltype(auto) DispatchStride(Slice<T, extent, stride> slice, Func&& func) {
+  if constexpr (stride != dynamic_stride) {
+    return std::invoke(func, slice);
+  } else {
+    return detail::StrideDispatcher<Strides>::Dispatch(slice, func);
+  }
+}
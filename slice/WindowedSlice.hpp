@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "../span/Span.hpp"
+#include "Slice.hpp"
+#include "ZipSlice.hpp"
+
+// WindowedSlice
+//
+// View of the windows [k * step, k * step + window) of a base slice, for
+// every k where the window fits. Window size and step are static or
+// dynamic_extent. Windows of a contiguous base are Spans, of a strided base
+// Slices with the base stride.
+template <typename T, std::size_t window = dynamic_extent, std::size_t step = dynamic_extent, std::ptrdiff_t stride = 1>
+class WindowedSlice {
+ public:
+  using window_type = std::conditional_t<stride == 1, Span<T, window>, Slice<T, window, stride>>;
+  using element_type    = T;
+  using value_type      = std::remove_cv_t<T>;
+  using reference       = window_type;
+  using size_type       = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  class iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = window_type;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = window_type;
+
+    constexpr iterator() noexcept = default;
+
+    constexpr iterator(const WindowedSlice& view, std::size_t index) noexcept
+      : view_{view}
+      , index_{index} {
+    }
+
+    [[nodiscard]] constexpr reference operator*() const noexcept {
+      return view_[index_];
+    }
+
+    constexpr reference operator[](const difference_type offset) const noexcept {
+      return view_[index_ + offset];
+    }
+
+    constexpr iterator& operator++() noexcept {
+      ++index_;
+      return *this;
+    }
+
+    constexpr iterator operator++(int) noexcept {
+      iterator tmp{*this};
+      ++index_;
+      return tmp;
+    }
+
+    constexpr iterator& operator--() noexcept {
+      --index_;
+      return *this;
+    }
+
+    constexpr iterator operator--(int) noexcept {
+      iterator tmp{*this};
+      --index_;
+      return tmp;
+    }
+
+    constexpr iterator& operator+=(const difference_type offset) noexcept {
+      index_ += offset;
+      return *this;
+    }
+
+    constexpr iterator& operator-=(const difference_type offset) noexcept {
+      index_ -= offset;
+      return *this;
+    }
+
+    [[nodiscard]] constexpr iterator operator+(const difference_type offset) const noexcept {
+      return {view_, index_ + offset};
+    }
+
+    friend constexpr iterator operator+(const difference_type offset, iterator iter) noexcept {
+      return iter + offset;
+    }
+
+    [[nodiscard]] constexpr iterator operator-(const difference_type offset) const noexcept {
+      return {view_, index_ - offset};
+    }
+
+    [[nodiscard]] constexpr difference_type operator-(const iterator& other) const noexcept {
+      return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    [[nodiscard]] constexpr bool operator==(const iterator& rhs) const noexcept {
+      return index_ == rhs.index_;
+    }
+
+    [[nodiscard]] constexpr auto operator<=>(const iterator& rhs) const noexcept {
+      return index_ <=> rhs.index_;
+    }
+
+   private:
+    // A copy, so the iterator outlives the view it came from.
+    WindowedSlice view_{};
+    std::size_t index_ = 0;
+  };
+
+  constexpr WindowedSlice(Slice<T, dynamic_extent, stride> base, std::size_t window_size = window,
+                          std::size_t step_size = step) noexcept
+    : base_{base}
+    , window_{window_size}
+    , step_{step_size} {
+    assert(window == dynamic_extent || window_size == window);
+    assert(step == dynamic_extent || step_size == step);
+    assert(WindowSize() > 0 && Step() > 0);
+  }
+
+  // Number of whole windows, none when the base is shorter than one window.
+  constexpr std::size_t Size() const noexcept {
+    return base_.Size() < WindowSize() ? 0 : (base_.Size() - WindowSize()) / Step() + 1;
+  }
+
+  constexpr bool Empty() const noexcept {
+    return Size() == 0;
+  }
+
+  constexpr std::size_t WindowSize() const noexcept {
+    return window_.Size();
+  }
+
+  constexpr std::size_t Step() const noexcept {
+    return step_.Size();
+  }
+
+  constexpr const Slice<T, dynamic_extent, stride>& Base() const noexcept {
+    return base_;
+  }
+
+  // Position in the base of the first element of window index.
+  constexpr std::size_t Start(std::size_t index) const noexcept {
+    return index * Step();
+  }
+
+  constexpr reference operator[](std::size_t index) const noexcept {
+    assert(index < Size());
+    auto* first = base_.Data() + static_cast<std::ptrdiff_t>(Start(index)) * base_.Stride();
+    if constexpr (stride == 1) {
+      return window_type{first, WindowSize()};
+    } else {
+      return window_type{first, WindowSize(), base_.Stride()};
+    }
+  }
+
+  [[nodiscard]] constexpr iterator begin() const noexcept {
+    return {*this, 0};
+  }
+
+  [[nodiscard]] constexpr iterator end() const noexcept {
+    return {*this, Size()};
+  }
+
+ private:
+  // Only for default-constructed iterators.
+  constexpr WindowedSlice() noexcept = default;
+
+  Slice<T, dynamic_extent, stride> base_;
+  [[no_unique_address]] detail::SizeBase<window> window_;
+  [[no_unique_address]] detail::SizeBase<step> step_;
+};
+
+namespace detail {
+
+template <std::size_t window, std::size_t step, typename Range>
+constexpr auto MakeWindows(const Range& base, std::size_t window_size, std::size_t step_size) noexcept {
+  using BaseSlice = decltype(AsSlice(base));
+  using T = typename BaseSlice::element_type;
+  constexpr auto stride = SliceStride<BaseSlice>::value;
+  const auto slice = AsSlice(base);
+  return WindowedSlice<T, window, step, stride>{{slice.Data(), slice.Size(), slice.Stride()}, window_size, step_size};
+}
+
+} // namespace detail
+
+
+// Windows of window_size elements starting every step_size elements of any
+// Span or Slice.
+template <typename Range>
+constexpr auto Windows(const Range& base, std::size_t window_size, std::size_t step_size = 1) noexcept {
+  return detail::MakeWindows<dynamic_extent, dynamic_extent>(base, window_size, step_size);
+}
+
+template <std::size_t window, std::size_t step = 1, typename Range>
+constexpr auto Windows(const Range& base) noexcept {
+  return detail::MakeWindows<window, step>(base, window, step);
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../span/Span.hpp"
+#include "Slice.hpp"
+
+namespace detail {
+
+template <typename S>
+struct IsSlice : std::false_type {};
+
+template <typename T, std::size_t extent, std::ptrdiff_t stride>
+struct IsSlice<Slice<T, extent, stride>> : std::true_type {};
+
+template <typename S>
+struct SliceExtent;
+
+template <typename T, std::size_t extent, std::ptrdiff_t stride>
+struct SliceExtent<Slice<T, extent, stride>> : std::integral_constant<std::size_t, extent> {};
+
+template <typename S>
+struct SliceStride;
+
+template <typename T, std::size_t extent, std::ptrdiff_t stride>
+struct SliceStride<Slice<T, extent, stride>> : std::integral_constant<std::ptrdiff_t, stride> {};
+
+template <std::size_t... extents>
+consteval bool ExtentsMatch() noexcept {
+  std::size_t known = dynamic_extent;
+  for (const auto extent : {extents...}) {
+    if (extent != dynamic_extent) {
+      if (known != dynamic_extent && known != extent) {
+        return false;
+      }
+      known = extent;
+    }
+  }
+  return true;
+}
+
+template <typename T, std::size_t extent, std::ptrdiff_t stride>
+constexpr Slice<T, extent, stride> AsSlice(Slice<T, extent, stride> slice) noexcept {
+  return slice;
+}
+
+template <typename T, std::size_t size>
+constexpr Slice<T, size, 1> AsSlice(Span<T, size> span) noexcept {
+  return {span.Data(), span.Size(), 1};
+}
+
+} // namespace detail
+
+
+// ZipSlice
+//
+// Lockstep view over several slices of equal size addressed by one shared
+// index. Element i is a tuple of references to element i of every slice.
+//
+// Iterators carry copies of the slices, so they outlive the ZipSlice they
+// came from. The tuple of references is a proxy: the iterator meets the
+// LegacyRandomAccessIterator requirements but not std::random_access_iterator,
+// since C++20 gives tuple<T&...> and tuple<T...> no common reference, and
+// algorithms that swap through *iter (std::sort) do not work on it.
+template <typename... Slices>
+requires (sizeof...(Slices) > 0) && (detail::IsSlice<Slices>::value && ...)
+class ZipSlice {
+ public:
+  using reference       = std::tuple<typename Slices::reference...>;
+  using value_type      = std::tuple<typename Slices::value_type...>;
+  using size_type       = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  static constexpr bool StaticStrides = ((detail::SliceStride<Slices>::value != dynamic_stride) && ...);
+
+  class iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = ZipSlice::value_type;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = ZipSlice::reference;
+
+    constexpr iterator() noexcept = default;
+
+    constexpr iterator(const std::tuple<Slices...>& slices, std::size_t index) noexcept
+      : slices_{slices}
+      , index_{index} {
+    }
+
+    [[nodiscard]] constexpr reference operator*() const noexcept {
+      return At(slices_, index_);
+    }
+
+    constexpr reference operator[](const difference_type offset) const noexcept {
+      return At(slices_, index_ + offset);
+    }
+
+    constexpr iterator& operator++() noexcept {
+      ++index_;
+      return *this;
+    }
+
+    constexpr iterator operator++(int) noexcept {
+      iterator tmp{*this};
+      ++index_;
+      return tmp;
+    }
+
+    constexpr iterator& operator--() noexcept {
+      --index_;
+      return *this;
+    }
+
+    constexpr iterator operator--(int) noexcept {
+      iterator tmp{*this};
+      --index_;
+      return tmp;
+    }
+
+    constexpr iterator& operator+=(const difference_type offset) noexcept {
+      index_ += offset;
+      return *this;
+    }
+
+    constexpr iterator& operator-=(const difference_type offset) noexcept {
+      index_ -= offset;
+      return *this;
+    }
+
+    [[nodiscard]] constexpr iterator operator+(const difference_type offset) const noexcept {
+      return {slices_, index_ + offset};
+    }
+
+    friend constexpr iterator operator+(const difference_type offset, iterator iter) noexcept {
+      return iter + offset;
+    }
+
+    [[nodiscard]] constexpr iterator operator-(const difference_type offset) const noexcept {
+      return {slices_, index_ - offset};
+    }
+
+    [[nodiscard]] constexpr difference_type operator-(const iterator& other) const noexcept {
+      return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    [[nodiscard]] constexpr bool operator==(const iterator& rhs) const noexcept {
+      return index_ == rhs.index_;
+    }
+
+    [[nodiscard]] constexpr auto operator<=>(const iterator& rhs) const noexcept {
+      return index_ <=> rhs.index_;
+    }
+
+   private:
+    std::tuple<Slices...> slices_;
+    std::size_t index_ = 0;
+  };
+
+  constexpr explicit ZipSlice(Slices... slices) noexcept
+    : slices_{slices...} {
+    static_assert(detail::ExtentsMatch<detail::SliceExtent<Slices>::value...>(), "zipped slices must have equal extents");
+    assert(((slices.Size() == Size()) && ...));
+  }
+
+  constexpr std::size_t Size() const noexcept {
+    return std::get<0>(slices_).Size();
+  }
+
+  constexpr bool Empty() const noexcept {
+    return Size() == 0;
+  }
+
+  template <std::size_t index>
+  constexpr const auto& Get() const noexcept {
+    return std::get<index>(slices_);
+  }
+
+  constexpr reference operator[](std::size_t index) const noexcept {
+    assert(index < Size());
+    return At(slices_, index);
+  }
+
+  [[nodiscard]] constexpr iterator begin() const noexcept {
+    return {slices_, 0};
+  }
+
+  [[nodiscard]] constexpr iterator end() const noexcept {
+    return {slices_, Size()};
+  }
+
+  // Calls func(a[i], b[i], ...) for every i. When all strides are 1 at
+  // runtime the loop is versioned into a contiguous one.
+  template <typename Func>
+  constexpr void ForEach(Func&& func) const {
+    [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+      const std::size_t size = Size();
+      const std::tuple data{std::get<indices>(slices_).Data()...};
+
+      if constexpr (!StaticStrides) {
+        if (((std::get<indices>(slices_).Stride() == 1) && ...)) {
+          for (std::size_t i = 0; i < size; ++i) {
+            func(std::get<indices>(data)[i]...);
+          }
+          return;
+        }
+      }
+
+      const std::tuple strides{std::get<indices>(slices_).Stride()...};
+      for (std::size_t i = 0; i < size; ++i) {
+        func(std::get<indices>(data)[static_cast<std::ptrdiff_t>(i) * std::get<indices>(strides)]...);
+      }
+    }(std::index_sequence_for<Slices...>{});
+  }
+
+  // out[i] = func(a[i], b[i], ...), out is any slice or span of matching size.
+  template <typename Out, typename Func>
+  constexpr void Transform(Out&& out, Func&& func) const {
+    assert(out.Size() == Size());
+    [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+      using OutSlice = decltype(detail::AsSlice(out));
+      ZipSlice<OutSlice, Slices...> zip{detail::AsSlice(out), std::get<indices>(slices_)...};
+      zip.ForEach([&](auto& result, auto&... values) {
+        result = func(values...);
+      });
+    }(std::index_sequence_for<Slices...>{});
+  }
+
+ private:
+  static constexpr reference At(const std::tuple<Slices...>& slices, std::size_t index) noexcept {
+    return std::apply([index](const auto&... slice) { return reference{slice[index]...}; }, slices);
+  }
+
+  std::tuple<Slices...> slices_;
+};
+
+template <typename... Ranges>
+constexpr auto Zip(const Ranges&... ranges) noexcept {
+  return ZipSlice<decltype(detail::AsSlice(ranges))...>{detail::AsSlice(ranges)...};
+}
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../slice/Prefetch.hpp"
+#include "../slice/Slice.hpp"
+#include "../slice/ZipSlice.hpp"
+#include "../span/Span.hpp"
+
+template <typename K>
+concept RadixKey = (std::integral<K> || std::floating_point<K>) && !std::same_as<K, bool> &&
+                   (sizeof(K) == 1 || sizeof(K) == 2 || sizeof(K) == 4 || sizeof(K) == 8);
+
+namespace detail {
+
+template <std::size_t size>
+using UnsignedOfSize = std::conditional_t<size == 1, std::uint8_t,
+                       std::conditional_t<size == 2, std::uint16_t,
+                       std::conditional_t<size == 4, std::uint32_t, std::uint64_t>>>;
+
+// Order-preserving map of a key onto unsigned bits. Negative floats sort
+// below -0.0 below +0.0 below positive floats, NaNs end up at the extremes.
+template <RadixKey K>
+constexpr UnsignedOfSize<sizeof(K)> ToRadixBits(K key) noexcept {
+  using Bits = UnsignedOfSize<sizeof(K)>;
+  constexpr Bits sign = Bits{1} << (sizeof(K) * 8 - 1);
+  const auto bits = std::bit_cast<Bits>(key);
+  if constexpr (std::floating_point<K>) {
+    return bits & sign ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | sign);
+  } else if constexpr (std::is_signed_v<K>) {
+    return static_cast<Bits>(bits ^ sign);
+  } else {
+    return bits;
+  }
+}
+
+template <RadixKey K>
+constexpr K FromRadixBits(UnsignedOfSize<sizeof(K)> bits) noexcept {
+  using Bits = UnsignedOfSize<sizeof(K)>;
+  constexpr Bits sign = Bits{1} << (sizeof(K) * 8 - 1);
+  if constexpr (std::floating_point<K>) {
+    return std::bit_cast<K>(bits & sign ? static_cast<Bits>(bits ^ sign) : static_cast<Bits>(~bits));
+  } else if constexpr (std::is_signed_v<K>) {
+    return std::bit_cast<K>(static_cast<Bits>(bits ^ sign));
+  } else {
+    return bits;
+  }
+}
+
+template <typename Bits>
+struct RadixEntry {
+  Bits key;
+  std::uint32_t index;
+};
+
+inline constexpr std::size_t RadixBuckets = 256;
+// Below this many keys per thread the extra threads cost more than they save.
+inline constexpr std::size_t RadixKeysPerThread = 1 << 16;
+
+using RadixHistogram = std::array<std::uint32_t, RadixBuckets>;
+
+// Stable LSD sort of (key bits, position) pairs with 8-bit digits, so each
+// thread's histogram stays in L1 and a scatter writes to at most 256
+// streams. Keys are split into one contiguous chunk per thread. Each pass
+// counts the digit per chunk and then scatters every chunk to offsets
+// ordered by bucket first and chunk second. Passes where all keys share a
+// digit are skipped.
+template <typename T, std::size_t extent, std::ptrdiff_t stride>
+std::vector<RadixEntry<UnsignedOfSize<sizeof(T)>>> RadixSortedEntries(Slice<T, extent, stride> keys, std::size_t threads) {
+  using K = std::remove_cv_t<T>;
+  using Bits = UnsignedOfSize<sizeof(K)>;
+  using Entry = RadixEntry<Bits>;
+  constexpr std::size_t digits = sizeof(K);
+
+  const std::size_t size = keys.Size();
+  assert(size <= std::numeric_limits<std::uint32_t>::max());
+  threads = std::clamp<std::size_t>(std::min(threads, size / RadixKeysPerThread), 1, 256);
+
+  std::vector<Entry> source(size);
+  std::vector<Entry> target(size);
+  std::vector<std::array<RadixHistogram, digits>> histograms(threads);
+  std::barrier sync{static_cast<std::ptrdiff_t>(threads)};
+
+  auto worker = [&](std::size_t thread) {
+    const std::size_t first = size * thread / threads;
+    const std::size_t last = size * (thread + 1) / threads;
+    auto& histogram = histograms[thread];
+    histogram = {};
+
+    // The only pass over the strided keys: counts every digit at once, which
+    // is exact for the first pass and tells which passes can be skipped.
+    for (std::size_t i = first; i < last; ++i) {
+      const Bits bits = ToRadixBits<K>(keys[i]);
+      source[i] = {bits, static_cast<std::uint32_t>(i)};
+      for (std::size_t digit = 0; digit < digits; ++digit) {
+        ++histogram[digit][(bits >> (digit * 8)) & 0xFF];
+      }
+    }
+    sync.arrive_and_wait();
+
+    std::array<bool, digits> needed{};
+    for (std::size_t digit = 0; digit < digits; ++digit) {
+      for (std::size_t bucket = 0; bucket < RadixBuckets && !needed[digit]; ++bucket) {
+        std::size_t total = 0;
+        for (const auto& other : histograms) {
+          total += other[digit][bucket];
+        }
+        needed[digit] = total != 0 && total != size;
+      }
+    }
+
+    auto* from = &source;
+    auto* to = &target;
+    bool counted = true;
+    for (std::size_t digit = 0; digit < digits; ++digit) {
+      if (!needed[digit]) {
+        continue;
+      }
+      const unsigned shift = static_cast<unsigned>(digit * 8);
+      if (!counted) {
+        histogram[digit] = {};
+        for (std::size_t i = first; i < last; ++i) {
+          ++histogram[digit][((*from)[i].key >> shift) & 0xFF];
+        }
+        sync.arrive_and_wait();
+      }
+      counted = false;
+
+      RadixHistogram offsets;
+      std::size_t offset = 0;
+      for (std::size_t bucket = 0; bucket < RadixBuckets; ++bucket) {
+        for (std::size_t other = 0; other < threads; ++other) {
+          if (other == thread) {
+            offsets[bucket] = static_cast<std::uint32_t>(offset);
+          }
+          offset += histograms[other][digit][bucket];
+        }
+      }
+      for (std::size_t i = first; i < last; ++i) {
+        const Entry entry = (*from)[i];
+        (*to)[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+      }
+      std::swap(from, to);
+      sync.arrive_and_wait();
+    }
+    return from;
+  };
+
+  std::vector<std::thread> helpers;
+  for (std::size_t thread = 1; thread < threads; ++thread) {
+    helpers.emplace_back(worker, thread);
+  }
+  auto* result = worker(0);
+  for (auto& helper : helpers) {
+    helper.join();
+  }
+  return std::move(*result);
+}
+
+// Runs func(first, last) over `threads` contiguous chunks of [0, size).
+template <typename Func>
+void ParallelChunks(std::size_t threads, std::size_t size, Func&& func) {
+  threads = std::clamp<std::size_t>(std::min(threads, size / RadixKeysPerThread), 1, 256);
+  std::vector<std::thread> helpers;
+  for (std::size_t thread = 1; thread < threads; ++thread) {
+    helpers.emplace_back([&, thread] { func(size * thread / threads, size * (thread + 1) / threads); });
+  }
+  func(0, size / threads);
+  for (auto& helper : helpers) {
+    helper.join();
+  }
+}
+
+// Moves element permutation[i] of every slice to position i. Gathering into
+// scratch buffers and moving back keeps the loads independent, following the
+// permutation cycles in place would make every step wait on a cache miss.
+// All slices are gathered in one pass, so fields of one record that share a
+// cache line cost a single miss.
+template <typename... Slices>
+void ApplyPermutation(Span<const std::uint32_t> permutation, std::size_t threads, const Slices&... slices) {
+  constexpr std::size_t prefetch_distance = 16;
+  const std::size_t size = permutation.Size();
+  std::tuple gathered{std::vector<typename Slices::value_type>(size)...};
+
+  [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+    ParallelChunks(threads, size, [&](std::size_t first, std::size_t last) {
+      for (std::size_t i = first; i < last; ++i) {
+        if (i + prefetch_distance < last) {
+          const auto ahead = permutation[i + prefetch_distance];
+          (PrefetchAddress<PrefetchMode::Read>(reinterpret_cast<std::uintptr_t>(&slices[ahead])), ...);
+        }
+        const auto source = permutation[i];
+        ((std::get<indices>(gathered)[i] = std::move(slices[source])), ...);
+      }
+    });
+    ParallelChunks(threads, size, [&](std::size_t first, std::size_t last) {
+      for (std::size_t i = first; i < last; ++i) {
+        ((slices[i] = std::move(std::get<indices>(gathered)[i])), ...);
+      }
+    });
+  }(std::index_sequence_for<Slices...>{});
+}
+
+} // namespace detail
+
+
+// Writes to permutation the positions of keys in stable ascending key order,
+// keys[permutation[0]] being the smallest. keys is any Span or Slice of
+// integer or floating point values.
+template <typename Keys>
+void RadixArgsort(const Keys& keys, Span<std::uint32_t> permutation, std::size_t threads = 1) {
+  const auto slice = detail::AsSlice(keys);
+  static_assert(RadixKey<std::remove_cv_t<typename decltype(slice)::element_type>>, "keys must be integers or floats");
+  assert(permutation.Size() == slice.Size());
+  const auto entries = detail::RadixSortedEntries(slice, threads);
+  detail::ParallelChunks(threads, entries.size(), [&](std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      permutation[i] = entries[i].index;
+    }
+  });
+}
+
+// Sorts keys in place, stable, and reorders every companion Span or Slice
+// the same way, so records stored column by column stay aligned.
+template <typename Keys, typename... Companions>
+void ParallelRadixSort(std::size_t threads, const Keys& keys, const Companions&... companions) {
+  const auto slice = detail::AsSlice(keys);
+  using K = std::remove_cv_t<typename decltype(slice)::element_type>;
+  static_assert(RadixKey<K>, "keys must be integers or floats");
+  assert(((detail::AsSlice(companions).Size() == slice.Size()) && ...));
+
+  const auto entries = detail::RadixSortedEntries(slice, threads);
+  std::vector<std::uint32_t> permutation(sizeof...(Companions) > 0 ? entries.size() : 0);
+  detail::ParallelChunks(threads, entries.size(), [&](std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      slice[i] = detail::FromRadixBits<K>(entries[i].key);
+      if constexpr (sizeof...(Companions) > 0) {
+        permutation[i] = entries[i].index;
+      }
+    }
+  });
+  if constexpr (sizeof...(Companions) > 0) {
+    detail::ApplyPermutation(Span<const std::uint32_t>{permutation.data(), permutation.size()}, threads,
+                             detail::AsSlice(companions)...);
+  }
+}
+
+template <typename Keys, typename... Companions>
+void RadixSort(const Keys& keys, const Companions&... companions) {
+  ParallelRadixSort(1, keys, companions...);
+}
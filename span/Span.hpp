@@ -1,3 +1,6 @@
+#pragma once
+
+#include <array>
 #include <cassert>
 #include <iterator>
 #include <limits>
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "../type_lists/type_lists.hpp"
+
+// A byte at `offset` of T never holds a value in [first_free, 255]. Specialize
+// to let CompactVariant keep its discriminant inside such a byte.
+template <typename T>
+struct VariantNiche {};
+
+template <>
+struct VariantNiche<bool> {
+  static constexpr std::size_t offset = 0;
+  static constexpr std::uint8_t first_free = 2;
+};
+
+namespace detail {
+
+// Holds the indices 0 .. count - 1.
+template <std::size_t count>
+using Discriminant = std::conditional_t<
+  count - 1 <= std::numeric_limits<std::uint8_t>::max(), std::uint8_t,
+  std::conditional_t<count - 1 <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t, std::uint32_t>>;
+
+template <typename T>
+concept HasVariantNiche = requires {
+  { VariantNiche<T>::offset } -> std::convertible_to<std::size_t>;
+  { VariantNiche<T>::first_free } -> std::convertible_to<std::uint8_t>;
+};
+
+struct NoDiscriminant {};
+
+// Niche packing applies when one alternative carries data and has a niche
+// large enough for the indices of all the empty ones.
+template <typename... Ts>
+consteval std::size_t NicheAlternative() noexcept {
+  constexpr std::array<bool, sizeof...(Ts)> empty{std::is_empty_v<Ts>...};
+  const auto dataful = std::count(empty.begin(), empty.end(), false);
+  if (dataful != 1) {
+    return sizeof...(Ts);
+  }
+  const std::size_t index = std::find(empty.begin(), empty.end(), false) - empty.begin();
+  std::size_t i = 0;
+  bool fits = false;
+  ([&] {
+    if constexpr (HasVariantNiche<Ts>) {
+      if (i == index) {
+        fits = VariantNiche<Ts>::offset < sizeof(Ts) &&
+               256 - std::size_t{VariantNiche<Ts>::first_free} >= sizeof...(Ts) - 1;
+      }
+    }
+    ++i;
+  }(), ...);
+  return fits ? index : sizeof...(Ts);
+}
+
+template <typename Self, typename T>
+using ForwardAlternative = std::conditional_t<
+  std::is_lvalue_reference_v<Self>,
+  std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>, const T&, T&>,
+  std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>, const T&&, T&&>>;
+
+} // namespace detail
+
+
+// BasicCompactVariant
+//
+// Tagged union with the smallest discriminant that fits. The discriminant
+// follows the storage of the largest alternative, so a variant is that size
+// plus the discriminant rounded up to the strictest alignment; padding inside
+// an alternative is not reused. Every operation dispatches through a flat
+// table of per-alternative thunks.
+template <typename... Ts>
+requires (sizeof...(Ts) > 0) && ((std::is_object_v<Ts> && !std::is_array_v<Ts>) && ...)
+class BasicCompactVariant {
+ private:
+  using Alternatives = type_lists::FromTuple<type_tuples::TTuple<Ts...>>;
+
+  static constexpr std::size_t niche_alternative_ = detail::NicheAlternative<Ts...>();
+  static constexpr bool uses_niche_ = niche_alternative_ < sizeof...(Ts);
+
+  using DiscriminantStorage = std::conditional_t<uses_niche_, detail::NoDiscriminant, detail::Discriminant<sizeof...(Ts)>>;
+
+  static constexpr bool trivially_destructible_ = (std::is_trivially_destructible_v<Ts> && ...);
+  static constexpr bool trivially_copyable_ = (std::is_trivially_copyable_v<Ts> && ...);
+
+  template <typename T>
+  static constexpr std::size_t IndexOfImpl() noexcept {
+    constexpr std::array<bool, sizeof...(Ts)> matches{std::is_same_v<T, Ts>...};
+    static_assert(std::count(matches.begin(), matches.end(), true) == 1, "type must be exactly one alternative");
+    return std::find(matches.begin(), matches.end(), true) - matches.begin();
+  }
+
+ public:
+  template <std::size_t index>
+  using Alternative = typename type_lists::Drop<index, Alternatives>::Head;
+
+  template <typename T>
+  static constexpr std::size_t IndexOf = IndexOfImpl<T>();
+
+  static constexpr std::size_t AlternativeCount() noexcept {
+    return sizeof...(Ts);
+  }
+
+  static constexpr bool UsesNiche() noexcept {
+    return uses_niche_;
+  }
+
+  BasicCompactVariant() noexcept(std::is_nothrow_default_constructible_v<Alternative<0>>)
+  requires std::is_default_constructible_v<Alternative<0>> {
+    Construct<0>();
+  }
+
+  template <typename T>
+  requires (std::is_same_v<std::remove_cvref_t<T>, Ts> || ...)
+  BasicCompactVariant(T&& value) noexcept(std::is_nothrow_constructible_v<std::remove_cvref_t<T>, T&&>) {
+    Construct<IndexOf<std::remove_cvref_t<T>>>(std::forward<T>(value));
+  }
+
+  template <typename T, typename... Args>
+  explicit BasicCompactVariant(std::in_place_type_t<T>, Args&&... args) {
+    Construct<IndexOf<T>>(std::forward<Args>(args)...);
+  }
+
+  template <std::size_t index, typename... Args>
+  explicit BasicCompactVariant(std::in_place_index_t<index>, Args&&... args) {
+    Construct<index>(std::forward<Args>(args)...);
+  }
+
+  BasicCompactVariant(const BasicCompactVariant&) requires trivially_copyable_ = default;
+
+  BasicCompactVariant(const BasicCompactVariant& other)
+  requires (!trivially_copyable_) && (std::is_copy_constructible_v<Ts> && ...) {
+    other.Visit([this](const auto& value) {
+      Construct<IndexOf<std::remove_cvref_t<decltype(value)>>>(value);
+    });
+  }
+
+  BasicCompactVariant(BasicCompactVariant&&) requires trivially_copyable_ = default;
+
+  BasicCompactVariant(BasicCompactVariant&& other) noexcept((std::is_nothrow_move_constructible_v<Ts> && ...))
+  requires (!trivially_copyable_) && (std::is_move_constructible_v<Ts> && ...) {
+    std::move(other).Visit([this](auto&& value) {
+      Construct<IndexOf<std::remove_cvref_t<decltype(value)>>>(std::move(value));
+    });
+  }
+
+  BasicCompactVariant& operator=(const BasicCompactVariant&) requires trivially_copyable_ = default;
+
+  BasicCompactVariant& operator=(const BasicCompactVariant& other)
+  requires (!trivially_copyable_) && (std::is_copy_constructible_v<Ts> && ...) &&
+           (std::is_nothrow_move_constructible_v<Ts> && ...) {
+    if (this != &other) {
+      BasicCompactVariant copy{other};
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  BasicCompactVariant& operator=(BasicCompactVariant&&) requires trivially_copyable_ = default;
+
+  BasicCompactVariant& operator=(BasicCompactVariant&& other) noexcept
+  requires (!trivially_copyable_) && (std::is_nothrow_move_constructible_v<Ts> && ...) {
+    if (this != &other) {
+      Destroy();
+      std::move(other).Visit([this](auto&& value) {
+        Construct<IndexOf<std::remove_cvref_t<decltype(value)>>>(std::move(value));
+      });
+    }
+    return *this;
+  }
+
+  ~BasicCompactVariant() requires trivially_destructible_ = default;
+
+  ~BasicCompactVariant() {
+    Destroy();
+  }
+
+  std::size_t Index() const noexcept {
+    if constexpr (uses_niche_) {
+      constexpr std::size_t first_free = VariantNiche<Alternative<niche_alternative_>>::first_free;
+      const std::size_t niche = static_cast<std::uint8_t>(storage_[VariantNiche<Alternative<niche_alternative_>>::offset]);
+      if (niche < first_free) {
+        return niche_alternative_;
+      }
+      const auto index = niche - first_free;
+      return index + (index >= niche_alternative_);
+    } else {
+      return discriminant_;
+    }
+  }
+
+  template <typename T>
+  bool Holds() const noexcept {
+    return Index() == IndexOf<T>;
+  }
+
+  template <std::size_t index>
+  Alternative<index>& Get() noexcept {
+    assert(Index() == index);
+    return *std::launder(reinterpret_cast<Alternative<index>*>(storage_));
+  }
+
+  template <std::size_t index>
+  const Alternative<index>& Get() const noexcept {
+    assert(Index() == index);
+    return *std::launder(reinterpret_cast<const Alternative<index>*>(storage_));
+  }
+
+  template <typename T>
+  T& Get() noexcept {
+    return Get<IndexOf<T>>();
+  }
+
+  template <typename T>
+  const T& Get() const noexcept {
+    return Get<IndexOf<T>>();
+  }
+
+  template <typename T>
+  T* GetIf() noexcept {
+    return Holds<T>() ? &Get<T>() : nullptr;
+  }
+
+  template <typename T>
+  const T* GetIf() const noexcept {
+    return Holds<T>() ? &Get<T>() : nullptr;
+  }
+
+  // There is no valueless state, so the old value is only destroyed once
+  // nothing can throw: a throwing constructor builds into a temporary that
+  // is then moved in, and the variant keeps its old value if it throws.
+  template <std::size_t index, typename... Args>
+  requires std::is_nothrow_constructible_v<Alternative<index>, Args&&...> ||
+           std::is_nothrow_move_constructible_v<Alternative<index>>
+  Alternative<index>& Emplace(Args&&... args) {
+    if constexpr (std::is_nothrow_constructible_v<Alternative<index>, Args&&...>) {
+      Destroy();
+      Construct<index>(std::forward<Args>(args)...);
+    } else {
+      Alternative<index> value(std::forward<Args>(args)...);
+      Destroy();
+      Construct<index>(std::move(value));
+    }
+    return Get<index>();
+  }
+
+  template <typename T, typename... Args>
+  requires std::is_nothrow_constructible_v<T, Args&&...> || std::is_nothrow_move_constructible_v<T>
+  T& Emplace(Args&&... args) {
+    return Emplace<IndexOf<T>>(std::forward<Args>(args)...);
+  }
+
+  template <typename Visitor>
+  decltype(auto) Visit(Visitor&& visitor) & {
+    return VisitImpl(*this, std::forward<Visitor>(visitor));
+  }
+
+  template <typename Visitor>
+  decltype(auto) Visit(Visitor&& visitor) const& {
+    return VisitImpl(*this, std::forward<Visitor>(visitor));
+  }
+
+  template <typename Visitor>
+  decltype(auto) Visit(Visitor&& visitor) && {
+    return VisitImpl(std::move(*this), std::forward<Visitor>(visitor));
+  }
+
+ private:
+  template <std::size_t index, typename... Args>
+  void Construct(Args&&... args) {
+    new (storage_) Alternative<index>(std::forward<Args>(args)...);
+    if constexpr (uses_niche_) {
+      if constexpr (index != niche_alternative_) {
+        constexpr std::size_t niche = VariantNiche<Alternative<niche_alternative_>>::offset;
+        const auto encoded = VariantNiche<Alternative<niche_alternative_>>::first_free + index - (index > niche_alternative_);
+        storage_[niche] = static_cast<std::byte>(encoded);
+      }
+    } else {
+      discriminant_ = static_cast<DiscriminantStorage>(index);
+    }
+  }
+
+  void Destroy() noexcept {
+    if constexpr (!trivially_destructible_) {
+      Visit([](auto& value) { std::destroy_at(std::addressof(value)); });
+    }
+  }
+
+  template <typename Self, typename Visitor>
+  static decltype(auto) VisitImpl(Self&& self, Visitor&& visitor) {
+    using Result = std::invoke_result_t<Visitor, detail::ForwardAlternative<Self&&, Alternative<0>>>;
+    using Thunk = Result (*)(Self&&, Visitor&&);
+
+    static constexpr std::array<Thunk, sizeof...(Ts)> thunks{+[](Self&& self, Visitor&& visitor) -> Result {
+      using Stored = std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>, const Ts, Ts>;
+      auto* value = std::launder(reinterpret_cast<Stored*>(self.storage_));
+      return std::invoke(std::forward<Visitor>(visitor), static_cast<detail::ForwardAlternative<Self&&, Ts>>(*value));
+    }...};
+
+    return thunks[self.Index()](std::forward<Self>(self), std::forward<Visitor>(visitor));
+  }
+
+  alignas(Ts...) std::byte storage_[std::max({sizeof(Ts)...})];
+  [[no_unique_address]] DiscriminantStorage discriminant_;
+};
+
+
+namespace detail {
+
+template <typename Alternatives>
+struct CompactVariantOf;
+
+template <typename... Ts>
+struct CompactVariantOf<type_tuples::TTuple<Ts...>> {
+  using Type = BasicCompactVariant<Ts...>;
+};
+
+template <type_lists::TypeList TL>
+requires (!type_tuples::TypeTuple<TL>)
+struct CompactVariantOf<TL> : CompactVariantOf<type_lists::ToTuple<TL>> {};
+
+} // namespace detail
+
+// Alternatives are given as a type_tuples::TTuple or a finite TypeList.
+template <typename Alternatives>
+using CompactVariant = typename detail::CompactVariantOf<Alternatives>::Type;